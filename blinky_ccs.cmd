@@ -23,6 +23,7 @@
  *****************************************************************************/
 
 --retain=g_pfnVectors
+--retain="*(.os_tcbs)"
 
 /* The following command line options are set as part of the CCS project.    */
 /* If you are building using the command line, or for some reason want to    */
@@ -54,6 +55,12 @@ MEMORY
 SECTIONS
 {
     .intvecs:   > APP_BASE
+    /* RTOS kernel code (rtos/), gathered to measure its size */
+    .os_text    : { os.obj(.text) os-asm.obj(.text) systick0.obj(.text)
+                    timer0.obj(.text) dwt0.obj(.text) mpu0.obj(.text)
+                    os-queue.obj(.text) os-stream-buffer.obj(.text)
+                    os-event-tasks.obj(.text) os-future.obj(.text) }
+                  > FLASH, RUN_START(__OS_TEXT_START), RUN_END(__OS_TEXT_END)
     .text   :   > FLASH
     .const  :   > FLASH
     .cinit  :   > FLASH
@@ -65,6 +72,12 @@ SECTIONS
     .bss    :   > SRAM
     .sysmem :   > SRAM
     .stack  :   > SRAM
+
+    /* RTOS objects defined at compile time (rtos/) */
+    .os_tcbs    : > SRAM, RUN_START(__OS_TCBS_START), RUN_END(__OS_TCBS_END)
+    .os_stacks  : > SRAM
+    .os_objects : > SRAM
+    .os_noinit  : > SRAM, type = NOINIT /* retained across resets */
 }
 
 __STACK_TOP = __stack + 512;
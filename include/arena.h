@@ -0,0 +1,63 @@
+//*****************************************************************************
+//
+// Arena allocator, for scratch memory that lives as long as a request:
+//   parsing a command, formatting a frame, and the like.
+//
+// An arena is a buffer with a pointer to its first free byte, `top`.
+//   Allocating just moves `top` up, after aligning it to 8 bytes; the
+//   pieces allocated are never released one by one. Instead, `Arena_Mark`
+//   saves `top` at the start of the request, and `Arena_Reset` moves it
+//   back there at the end, releasing everything allocated in between at once.
+// Marks can be nested, as long as they're reset in reverse order.
+//
+// `Arena_Alloc` returns a NULL pointer when the arena is full; `peak` tells
+//   how much of the arena was ever used, to size its buffer.
+// An arena isn't protected against concurrent use: under the RTOS, give
+//   each thread its own arena, see OS_ThreadArenaSet in `rtos/os.h`.
+//
+// Usage:
+// ```c
+// #include "arena.h"
+//
+// ARENA_DEFINE(scratch, 256); // Arena scratch, uint64_t scratchBuffer[32]
+//
+// ArenaMark mark = Arena_Mark(&scratch);
+// char *command = Arena_Alloc(&scratch, len + 1);
+// ...
+// Arena_Reset(&scratch, mark);
+// ```
+//
+//*****************************************************************************
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stdint.h>
+
+#define ARENA_ALIGN 8 // alignment of every allocation, in bytes
+
+typedef struct Arena
+{
+    uint8_t *start; // first byte of the buffer
+    uint8_t *end;   // one past the last byte of the buffer
+    uint8_t *top;   // first free byte
+    uint8_t *peak;  // highest value of `top`
+} Arena;
+
+typedef uint8_t *ArenaMark;
+
+#define ARENA_DEFINE(arenaName, size)                                    \
+    uint64_t arenaName##Buffer[((size) + 7) / 8];                        \
+    Arena arenaName = {                                                  \
+        .start = (uint8_t *)arenaName##Buffer,                           \
+        .end = (uint8_t *)arenaName##Buffer + sizeof(arenaName##Buffer), \
+        .top = (uint8_t *)arenaName##Buffer,                             \
+        .peak = (uint8_t *)arenaName##Buffer}
+
+void Arena_Init(Arena *arena, void *buffer, uint32_t size);
+void *Arena_Alloc(Arena *arena, uint32_t size);
+ArenaMark Arena_Mark(Arena *arena);
+void Arena_Reset(Arena *arena, ArenaMark mark);
+uint32_t Arena_PeakGet(Arena *arena);
+
+#endif
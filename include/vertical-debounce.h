@@ -0,0 +1,46 @@
+//*****************************************************************************
+//
+// Debounce up to 32 inputs in parallel with vertical counters.
+// Each input has a 2-bit counter, whose bits are spread over two words:
+//   bit 0 of every counter is in `count0`, bit 1 in `count1`. So all the
+//   counters are updated together by a few bitwise operations.
+// A counter counts the consecutive samples in which its input differs from
+//   the debounced state, and is reset as soon as it doesn't. On the 4th
+//   consecutive sample, the debounced state of the input toggles.
+//
+// `VerticalDebounce_Update` is meant to be called from a periodic tick, e.g.
+//   every 5ms for 20ms of debouncing, with one bit per input in `sample`.
+// It returns the inputs whose debounced state toggled at this tick.
+//
+// Usage:
+// ```c
+// #include "vertical-debounce.h"
+//
+// VerticalDebounce buttons;
+// VerticalDebounce_Init(&buttons, GPIOPinRead(GPIO_PORTB_BASE, 0xFF));
+//
+// // every 5ms
+// uint32_t toggled = VerticalDebounce_Update(&buttons, GPIOPinRead(GPIO_PORTB_BASE, 0xFF));
+// uint32_t pressed = toggled & buttons.state;
+// uint32_t released = toggled & ~buttons.state;
+// ```
+//
+//*****************************************************************************
+
+#ifndef _VERTICAL_DEBOUNCE_H_
+#define _VERTICAL_DEBOUNCE_H_
+
+#include <stdint.h>
+
+typedef struct VerticalDebounce
+{
+    uint32_t state;  // debounced state, one bit per input
+    uint32_t count0; // bit 0 of each input's counter
+    uint32_t count1; // bit 1 of each input's counter
+} VerticalDebounce;
+
+void VerticalDebounce_Init(VerticalDebounce *debounce, uint32_t initialSample);
+
+uint32_t VerticalDebounce_Update(VerticalDebounce *debounce, uint32_t sample);
+
+#endif
@@ -6,6 +6,7 @@
 //     2 LEDs on - Sleep Mode
 //     1 LED on  - Deep-Sleep Mode
 // Timer0, in an ISR, toggles the LED on PE4 every 2 seconds.
+// Timer1 debounces the button on PC4, and runs only while the button is bouncing or pressed.
 //
 // Check the document at 'bin/17_power_modes.md' for the difference between power modes.
 // Circuit's diagram available in this repository.
@@ -20,6 +21,7 @@
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/timer.h"
+#include "vertical-debounce.h"
 
 #ifdef DEBUG
 void __error__(char *pcFilename, uint32_t ui32Line)
@@ -47,11 +49,18 @@ static void Timer0_PeriodicIntHandler(void);
 
 //
 // PC4, configured as input, fires the interrupt handler on rising edges.
-// The interrupt handler shifts to the next power mode and
+// The interrupt handler doesn't wait for the button to settle: it disables itself
+//  and starts Timer1, which samples PC4 every 5ms.
+// After 4 equal samples, Timer1's interrupt handler shifts to the next power mode and
 //  updates the LEDs indicating the current power mode.
+// Once the button is released, Timer1 is stopped and the PC4 interrupt enabled again.
 //
+#define TIMER1_LOAD_VALUE (SysCtlClockGet() / 200) // sample PC4 every 5ms
+static VerticalDebounce PC4Debounce;
 static void GPIO_PC4_Init(void);
 static void GPIO_PC4_RisingEdgeIntHandler(void);
+static void Timer1_Init(uint32_t timerLoadValue, void (*periodicIntHandler)(void));
+static void Timer1_DebounceIntHandler(void);
 
 //
 // PE012, configured as output, are updated (according to the global variable 'PowerMode')
@@ -67,6 +76,7 @@ int main(void)
     SysCtlClockSet(SYSCTL_SYSDIV_1 | SYSCTL_USE_OSC | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ);
 
     Timer0_Init(TIMER0_LOAD_VALUE, Timer0_PeriodicIntHandler);
+    Timer1_Init(TIMER1_LOAD_VALUE, Timer1_DebounceIntHandler);
     GPIO_PC4_Init();
     GPIO_PE0124_Init();
 
@@ -83,6 +93,8 @@ int main(void)
     //
     SysCtlPeripheralSleepEnable(SYSCTL_PERIPH_TIMER0);
     SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_TIMER0);
+    SysCtlPeripheralSleepEnable(SYSCTL_PERIPH_TIMER1);
+    SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_TIMER1);
     SysCtlPeripheralSleepEnable(SYSCTL_PERIPH_GPIOC);
     SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_GPIOC);
 
@@ -157,10 +169,43 @@ void GPIO_PC4_Init(void)
 
 void GPIO_PC4_RisingEdgeIntHandler(void)
 {
-    SysCtlDelay(SysCtlClockGet() / 10); // simple debouncing
     GPIOIntClear(GPIO_PORTC_BASE, GPIO_INT_PIN_4);
-    PowerMode = (PowerMode + 1) % 3;
-    GPIO_PE012_Set();
+    GPIOIntDisable(GPIO_PORTC_BASE, GPIO_INT_PIN_4);
+    VerticalDebounce_Init(&PC4Debounce, 0); // released
+    TimerEnable(TIMER1_BASE, TIMER_A);
+}
+
+void Timer1_Init(uint32_t timerLoadValue, void (*periodicIntHandler)(void))
+{
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER1))
+        ;
+    TimerConfigure(TIMER1_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER1_BASE, TIMER_A, timerLoadValue);
+    TimerIntRegister(TIMER1_BASE, TIMER_A, periodicIntHandler);
+    TimerIntEnable(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
+}
+
+void Timer1_DebounceIntHandler(void)
+{
+    TimerIntClear(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
+    uint32_t sample = GPIOPinRead(GPIO_PORTC_BASE, GPIO_PIN_4);
+    uint32_t toggled = VerticalDebounce_Update(&PC4Debounce, sample);
+    if (toggled & PC4Debounce.state)
+    {
+        // pressed
+        PowerMode = (PowerMode + 1) % 3;
+        GPIO_PE012_Set();
+    }
+
+    bool isSettled = (PC4Debounce.count0 | PC4Debounce.count1) == 0;
+    if (isSettled && (PC4Debounce.state == 0))
+    {
+        // released, wait for the next rising edge;
+        //  one latched during the last bounces just restarts the debouncing
+        TimerDisable(TIMER1_BASE, TIMER_A);
+        GPIOIntEnable(GPIO_PORTC_BASE, GPIO_INT_PIN_4);
+    }
 }
 
 void GPIO_PE0124_Init(void)
@@ -9,6 +9,9 @@
 // User commands are case-insensitive and end with dot "."
 // A wrong command blinks the red-LED onboard.
 //
+// The lowercase copy of the command is allocated from an arena, see
+//   `arena.h`, which is reset once the command is handled.
+//
 // Useful links and resources:
 // https://deepbluembedded.com/stm32-hc-05-bluetooth-module-examples/
 // https://components101.com/sites/default/files/component_datasheet/HC-05%20Datasheet.pdf
@@ -35,6 +38,7 @@
 #include "driverlib/pin_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
+#include "arena.h"
 #include "heart-beat.h"
 #include "macro-utils.h"
 #include "uart-init.h"
@@ -50,6 +54,11 @@ void __error__(char *pcFilename, uint32_t ui32Line)
 
 #define UART1_RX_BUFFER_LEN 10
 
+//
+// Scratch memory for handling one command.
+//
+ARENA_DEFINE(commandScratch, 64);
+
 static void UART1_StringPut(const char *str);
 
 static void OnboardRedLED_Init(void);
@@ -89,23 +98,36 @@ int main(void)
         rxChar = UARTCharGet(UART1_BASE);
         if (rxChar != '.')
         {
-            rxBuffer[rxBufferIdx] = tolower(rxChar);
+            rxBuffer[rxBufferIdx] = rxChar;
             rxBufferIdx = (rxBufferIdx + 1) % UART1_RX_BUFFER_LEN;
             continue;
         }
 
-        rxBuffer[rxBufferIdx] = '\0';
-        UARTprintf("Received command: %s\n", rxBuffer);
+        ArenaMark mark = Arena_Mark(&commandScratch);
+        char *command = Arena_Alloc(&commandScratch, rxBufferIdx + 1);
+        if (command == NULL)
+        {
+            UARTprintf("Command dropped, out of scratch memory\n");
+            rxBufferIdx = 0;
+            continue;
+        }
+        for (uint32_t idx = 0; idx < rxBufferIdx; idx++)
+        {
+            command[idx] = tolower(rxBuffer[idx]);
+        }
+        command[rxBufferIdx] = '\0';
+        UARTprintf("Received command: %s\n", command);
 
-        if (strcmp("set", rxBuffer) == 0)
+        if (strcmp("set", command) == 0)
             HeartBeat_Set();
-        else if (strcmp("reset", rxBuffer) == 0)
+        else if (strcmp("reset", command) == 0)
             HeartBeat_Reset();
-        else if (strcmp("toggle", rxBuffer) == 0)
+        else if (strcmp("toggle", command) == 0)
             HeartBeat_Toggle();
         else
             OnboardRedLED_DisplayError();
 
+        Arena_Reset(&commandScratch, mark);
         rxBufferIdx = 0;
     }
 }
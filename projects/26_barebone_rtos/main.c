@@ -2,16 +2,23 @@
 //
 // A barebone RTOS running on the Tiva LaunchPad.
 // In short:
-//   * Three hardcoded threads are linked together in a circular queue and their
-//     stack initialized with dummy values.
+//   * Three threads are defined at compile time with OS_THREAD_DEFINE, their
+//     stack initialized with dummy values, and linked together in a circular
+//     queue by OS_Init.
 //   * The first thread's stack is "restored" on the main stack and run.
 //   * The SysTick ISR triggers thread switching, which saves the stack of
 //     the current thread and restores the one of the next thread.
 //     The scheduler's algorithm decides which one is the next thread.
 //   * The Timer0 ISR decrements the value of `sleep` in the
 //     thread-control-blocks every ms.
-//   * OS_Suspend triggers thread switching without waiting for SysTick,
-//     OS_Sleep updates the value of `sleep` for the current thread-control-block.
+//   * OS_ThreadSuspend triggers thread switching without waiting for SysTick,
+//     OS_ThreadSleep updates the value of `sleep` for the current
+//     thread-control-block.
+//
+// The kernel is the one in `rtos/`, configured by `os-config.h` with just
+//   the features above.
+// Define `KERNEL_BENCHMARK` to run the kernel micro-benchmarks instead,
+//   see `kernel-benchmark.h`.
 //
 // The program can be tried by connecting PE0, PE1, and PE2 to a logic analyzer.
 //
@@ -25,6 +32,7 @@
 #include <stdbool.h>
 #include <driverlib/debug.h>
 #include "user-tasks.h"
+#include "kernel-benchmark.h"
 #include "os.h"
 
 #ifdef DEBUG
@@ -35,10 +43,19 @@ void __error__(char *pcFilename, uint32_t ui32Line)
 }
 #endif
 
+#ifndef KERNEL_BENCHMARK
+OS_THREAD_DEFINE(userTask0Thread, userTask0, 0, STACKSIZE);
+OS_THREAD_DEFINE(userTask1Thread, userTask1, 0, STACKSIZE);
+OS_THREAD_DEFINE(userTask2Thread, userTask2, 0, STACKSIZE);
+#endif
+
 int main(void)
 {
-    OS_AddThreads(userTask0, userTask1, userTask2);
-    OS_Init(THREADFREQ);
+#ifdef KERNEL_BENCHMARK
+    KernelBenchmark_Init();
+    OS_Launch();
+#endif
+    OS_Init(THREADFREQ, 0, 0, 0);
     OS_Launch();
 
     // This loop should not be reached.
@@ -0,0 +1,19 @@
+//*****************************************************************************
+//
+// Kernel features used by this project; see `rtos/os.h`.
+// Round-robin threads defined at compile time, which can only sleep.
+//
+//*****************************************************************************
+
+#ifndef OS_CONFIG_H_INCLUDED
+#define OS_CONFIG_H_INCLUDED
+
+#define OS_CONFIG_PRIORITY_SCHEDULER 0
+#define OS_CONFIG_SEMAPHORES 0
+#define OS_CONFIG_SLEEP 1
+#define OS_CONFIG_THREAD_CREATE_KILL 0
+#define OS_CONFIG_STACK_GUARD 0
+#define OS_CONFIG_CYCLES_ACCOUNTING 0
+#define OS_CONFIG_EVENT_TASKS 0
+
+#endif
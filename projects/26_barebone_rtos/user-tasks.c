@@ -42,7 +42,7 @@ void userTask1(void)
             InstrumentTriggerPE1_Toggle();
             SysCtlDelay(100);
         }
-        OS_Suspend();
+        OS_ThreadSuspend();
     }
 }
 
@@ -62,7 +62,7 @@ void userTask2(void)
         count++;
         if (count % 125 == 0)
         {
-            OS_Sleep(50);
+            OS_ThreadSleep(50);
         }
 
         InstrumentTriggerPE2_Toggle();
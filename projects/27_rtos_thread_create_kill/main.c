@@ -12,6 +12,10 @@
 //
 // The program can be tried by connecting PE0, PE1, and PE2 to a logic analyzer.
 //
+// The kernel is the one in `rtos/`, configured by `os-config.h`.
+// Define `KERNEL_BENCHMARK` to run the kernel micro-benchmarks instead,
+//   see `kernel-benchmark.h`.
+//
 // For reference:
 //   book "Real-Time Operating Systems for ARM Cortex-M Microcontrollers" page 191.
 // Date: 28-12-2021
@@ -22,6 +26,7 @@
 #include <stdbool.h>
 #include <driverlib/debug.h>
 #include "user-tasks.h"
+#include "kernel-benchmark.h"
 #include "os.h"
 
 #ifdef DEBUG
@@ -34,8 +39,12 @@ void __error__(char *pcFilename, uint32_t ui32Line)
 
 int main(void)
 {
-    OS_Init(THREADFREQ, userTask0);
-    OS_ERRCHECK(OS_ThreadCreate(userTask1));
+#ifdef KERNEL_BENCHMARK
+    KernelBenchmark_Init();
+    OS_Launch();
+#endif
+    OS_Init(THREADFREQ, userTask0, 0, "userTask0");
+    OS_ERRCHECK(OS_ThreadCreate(userTask1, 0, "userTask1"));
     OS_Launch();
 
     // This loop should not be reached.
@@ -19,7 +19,7 @@ void userTask0(void)
 
         if (count == 5000)
         {
-            OS_ERRCHECK(OS_ThreadCreate(userTask2));
+            OS_ERRCHECK(OS_ThreadCreate(userTask2, 0, "userTask2"));
         }
 
         if (count == 10000)
@@ -4,6 +4,10 @@
 // Use them to implement a FIFO queue and to debounce a switch.
 // See `os.h`, `semaphore-fifo.h`, and `switch-debounce.h`.
 //
+// The kernel is the one in `rtos/`, configured by `os-config.h`.
+// Define `KERNEL_BENCHMARK` to run the kernel micro-benchmarks instead,
+//   see `kernel-benchmark.h`.
+//
 // For reference:
 //   book "Real-Time Operating Systems for ARM Cortex-M Microcontrollers"
 //   from page 193 onwards.
@@ -15,6 +19,7 @@
 #include <stdbool.h>
 #include <driverlib/debug.h>
 #include "user-tasks.h"
+#include "kernel-benchmark.h"
 #include "os.h"
 
 #ifdef DEBUG
@@ -27,8 +32,12 @@ void __error__(char *pcFilename, uint32_t ui32Line)
 
 int main(void)
 {
-    OS_Init(THREADFREQ, userTask0);
-    OS_ERRCHECK(OS_ThreadCreate(userTask1));
+#ifdef KERNEL_BENCHMARK
+    KernelBenchmark_Init();
+    OS_Launch();
+#endif
+    OS_Init(THREADFREQ, userTask0, 0, "userTask0");
+    OS_ERRCHECK(OS_ThreadCreate(userTask1, 0, "userTask1"));
     OS_Launch();
 
     // This loop should not be reached.
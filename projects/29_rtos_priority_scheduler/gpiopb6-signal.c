@@ -12,7 +12,7 @@
 #define PORT GPIO_PORTB_BASE
 #define PIN GPIO_PIN_6
 
-int32_t GPIOPB6_Signal_RisingEdgeHit = 0;
+OS_SEMAPHORE_DEFINE(GPIOPB6_Signal_RisingEdgeHit, 0);
 
 static void risingEdgeIntHandler(void);
 
@@ -28,6 +28,8 @@ void GPIOPB6_Signal_Init(void)
 static void risingEdgeIntHandler(void)
 {
     GPIOIntClear(PORT, PIN);
-    OS_SemaphoreSignal(&GPIOPB6_Signal_RisingEdgeHit);
-    OS_ThreadSuspend();
+    if (GPIOPB6_Signal_RisingEdgeHit < 1)
+    {
+        OS_SemaphoreSignalFromISR(&GPIOPB6_Signal_RisingEdgeHit);
+    }
 }
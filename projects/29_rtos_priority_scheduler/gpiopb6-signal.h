@@ -2,6 +2,10 @@
 //
 // Set up GPIO PB6 to signal the semaphore `GPIOPB6_Signal_RisingEdgeHit`
 //   on rising edges.
+// The switch isn't debounced, so the semaphore is used as a binary one:
+//   the edges that come while a signal is still pending are dropped, and
+//   a bouncy press wakes the waiting thread at most twice, once for the
+//   first edge, and once more for the bounces that come while it runs.
 //
 //*****************************************************************************
 
@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <inc/hw_memmap.h>
+#include <driverlib/gpio.h>
+#include <driverlib/i2c.h>
+#include <driverlib/interrupt.h>
+#include <driverlib/pin_map.h>
+#include <driverlib/sysctl.h>
+#include "macro-utils.h"
+#include "os.h"
+#include "os-future.h"
+
+#include "i2c0pb23-async.h"
+
+//
+// The state of the transfer, checked first by the I2C0 interrupt: it's
+//   `TransferIdle` between transfers, so that a late interrupt is ignored,
+//   and `TransferStopping` after an error, until the interrupt of the stop.
+//
+typedef enum TransferState
+{
+    TransferIdle,
+    TransferSending,
+    TransferReceiving,
+    TransferStopping,
+} TransferState;
+
+//
+// The transfer in progress, shared with the I2C0 interrupt.
+// `busFree` is taken when a transfer starts, and given back by the
+//   interrupt when it completes, so that transfers don't overlap.
+//
+static volatile TransferState state = TransferIdle;
+static OS_Future *transferPt;
+static const uint8_t *txBytes;
+static uint8_t *rxBytes;
+static uint32_t bytesLen;
+static uint32_t bytesDone; // bytes acknowledged by the slave, or received
+static int32_t busFree = 1;
+
+//
+// The fn transferStart waits for the bus and sets up a transfer of `len`
+//   bytes. It returns false, with the future completed with `OS_ERR_IO`,
+//   if there's no byte to transfer.
+// The future is started only once the bus is taken, so that the transfer
+//   before, if any, can't complete it.
+//
+static bool transferStart(OS_Future *transfer, uint32_t len, TransferState newState);
+
+//
+// The fn masterIntHandler is called every time the master is done with
+//   a byte. It either issues the command for the next byte, or completes
+//   the future after the last one. On errors of a burst, it issues a stop
+//   first, and completes the future on the interrupt of the stop.
+//
+static void masterIntHandler(void);
+static void transferComplete(OS_Err result);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void I2C0PB23Async_Init(void)
+{
+    SysCtlPeripheralEnableAndReady(SYSCTL_PERIPH_GPIOB);
+    SysCtlPeripheralEnableAndReady(SYSCTL_PERIPH_I2C0);
+    GPIOPinConfigure(GPIO_PB2_I2C0SCL);
+    GPIOPinConfigure(GPIO_PB3_I2C0SDA);
+    GPIOPinTypeI2CSCL(GPIO_PORTB_BASE, GPIO_PIN_2);
+    GPIOPinTypeI2C(GPIO_PORTB_BASE, GPIO_PIN_3);
+    I2CMasterInitExpClk(I2C0_BASE, SysCtlClockGet(), true);
+    I2CIntRegister(I2C0_BASE, masterIntHandler);
+    I2CMasterIntEnable(I2C0_BASE);
+}
+
+OS_Future *I2C0PB23Async_BurstSend(uint8_t slaveAddress, const uint8_t *data, uint32_t len, OS_Future *transfer)
+{
+    if (!transferStart(transfer, len, TransferSending))
+        return transfer;
+
+    txBytes = data;
+    I2CMasterSlaveAddrSet(I2C0_BASE, slaveAddress, false);
+    I2CMasterDataPut(I2C0_BASE, data[0]);
+    I2CMasterControl(I2C0_BASE, (len == 1) ? I2C_MASTER_CMD_SINGLE_SEND
+                                           : I2C_MASTER_CMD_BURST_SEND_START);
+    return transfer;
+}
+
+OS_Future *I2C0PB23Async_BurstReceive(uint8_t slaveAddress, uint8_t *data, uint32_t len, OS_Future *transfer)
+{
+    if (!transferStart(transfer, len, TransferReceiving))
+        return transfer;
+
+    rxBytes = data;
+    I2CMasterSlaveAddrSet(I2C0_BASE, slaveAddress, true);
+    I2CMasterControl(I2C0_BASE, (len == 1) ? I2C_MASTER_CMD_SINGLE_RECEIVE
+                                           : I2C_MASTER_CMD_BURST_RECEIVE_START);
+    return transfer;
+}
+
+void I2C0PB23Async_Cancel(OS_Future *transfer)
+{
+    // from now on, the interrupt ignores the transfer
+    IntMasterDisable();
+    bool isCancelled = (state != TransferIdle) && (transferPt == transfer);
+    TransferState cancelledState = state;
+    state = TransferIdle;
+    IntMasterEnable();
+    if (!isCancelled)
+        return; // already completed
+
+    // wait for the current byte, then end the burst, unless already ending
+    while (I2CMasterBusy(I2C0_BASE))
+        ;
+    if ((cancelledState != TransferStopping) && (bytesLen > 1))
+    {
+        I2CMasterControl(I2C0_BASE, (cancelledState == TransferReceiving) ? I2C_MASTER_CMD_BURST_RECEIVE_ERROR_STOP
+                                                                          : I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+        while (I2CMasterBusy(I2C0_BASE))
+            ;
+    }
+
+    OS_SemaphoreSignal(&busFree);
+    OS_FutureComplete(transfer, OS_ERR_TIMEOUT, bytesDone);
+}
+
+static bool transferStart(OS_Future *transfer, uint32_t len, TransferState newState)
+{
+    if (len == 0)
+    {
+        OS_FutureStart(transfer);
+        OS_FutureComplete(transfer, OS_ERR_IO, 0);
+        return false;
+    }
+
+    OS_SemaphoreWait(&busFree);
+    OS_FutureStart(transfer);
+    transferPt = transfer;
+    bytesLen = len;
+    bytesDone = 0;
+    state = newState;
+    return true;
+}
+
+static void masterIntHandler(void)
+{
+    I2CMasterIntClear(I2C0_BASE);
+
+    if (state == TransferIdle)
+        return;
+
+    if (state == TransferStopping)
+    {
+        transferComplete(OS_ERR_IO);
+        return;
+    }
+
+    if (I2CMasterErr(I2C0_BASE) != I2C_MASTER_ERR_NONE)
+    {
+        if (bytesLen > 1)
+        {
+            I2CMasterControl(I2C0_BASE, (state == TransferReceiving) ? I2C_MASTER_CMD_BURST_RECEIVE_ERROR_STOP
+                                                                     : I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+            state = TransferStopping;
+            return;
+        }
+        transferComplete(OS_ERR_IO);
+        return;
+    }
+
+    if (state == TransferReceiving)
+    {
+        rxBytes[bytesDone] = I2CMasterDataGet(I2C0_BASE);
+    }
+    bytesDone++;
+    if (bytesDone == bytesLen)
+    {
+        transferComplete(OS_ERR_NONE);
+        return;
+    }
+
+    bool isLast = (bytesDone == bytesLen - 1);
+    if (state == TransferReceiving)
+    {
+        I2CMasterControl(I2C0_BASE, isLast ? I2C_MASTER_CMD_BURST_RECEIVE_FINISH
+                                           : I2C_MASTER_CMD_BURST_RECEIVE_CONT);
+    }
+    else
+    {
+        I2CMasterDataPut(I2C0_BASE, txBytes[bytesDone]);
+        I2CMasterControl(I2C0_BASE, isLast ? I2C_MASTER_CMD_BURST_SEND_FINISH
+                                           : I2C_MASTER_CMD_BURST_SEND_CONT);
+    }
+}
+
+static void transferComplete(OS_Err result)
+{
+    OS_Future *transfer = transferPt;
+    state = TransferIdle;
+    OS_SemaphoreSignalFromISR(&busFree);
+    OS_FutureComplete(transfer, result, bytesDone);
+}
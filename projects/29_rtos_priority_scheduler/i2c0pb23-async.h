@@ -0,0 +1,59 @@
+//*****************************************************************************
+//
+// Interrupt-driven I2C master on I2C0 (PB2 SCL, PB3 SDA), for threads.
+// Unlike the drivers of projects 24 and 25, which busy-wait on
+//   `I2CMasterBusy` after every byte, a transfer is started and the call
+//   returns a future right away: the I2C0 interrupt moves the following
+//   bytes, and completes the future after the last one.
+// The thread waiting for the transfer with `OS_Await` is blocked meanwhile,
+//   so the other threads run while the bytes are on the bus.
+//
+// The future is provided by the caller, so that threads sharing the bus
+//   each await their own transfer; transfers are serialized by the driver.
+// The future's `value` is the number of bytes transferred, and its result
+//   is `OS_ERR_IO` if the slave didn't acknowledge or the bus was lost, or
+//   right away if there's no byte to transfer.
+//
+// If `OS_AwaitTimeout` times out, the transfer is still on the bus, and the
+//   interrupt still writes to the caller's buffer: `I2C0PB23Async_Cancel`
+//   must be called before the buffer or the future are reused. It stops the
+//   transfer, releases the bus, and completes the future with `OS_ERR_TIMEOUT`,
+//   unless the transfer has completed meanwhile.
+//
+// Usage:
+// ```c
+// #include "i2c0pb23-async.h"
+//
+// I2C0PB23Async_Init();
+//
+// OS_Future transfer;
+// uint8_t commands[] = {0x00, 0xAF};
+// OS_ERRCHECK(OS_Await(I2C0PB23Async_BurstSend(0x3C, commands, 2, &transfer)));
+//
+// uint8_t temperature[2];
+// I2C0PB23Async_BurstReceive(0x48, temperature, 2, &transfer);
+// DoSomethingElse();
+// OS_Err err = OS_Await(&transfer);
+//
+// if (OS_AwaitTimeout(I2C0PB23Async_BurstReceive(0x48, temperature, 2, &transfer), 5) == OS_ERR_TIMEOUT)
+// {
+//     I2C0PB23Async_Cancel(&transfer);
+// }
+// ```
+//
+//*****************************************************************************
+
+#ifndef I2C0PB23_ASYNC_H_INCLUDED
+#define I2C0PB23_ASYNC_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+#include "os-future.h"
+
+void I2C0PB23Async_Init(void);
+OS_Future *I2C0PB23Async_BurstSend(uint8_t slaveAddress, const uint8_t *data, uint32_t len, OS_Future *transfer);
+OS_Future *I2C0PB23Async_BurstReceive(uint8_t slaveAddress, uint8_t *data, uint32_t len, OS_Future *transfer);
+void I2C0PB23Async_Cancel(OS_Future *transfer);
+
+#endif
@@ -0,0 +1,308 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inc/hw_memmap.h>
+#include <driverlib/debug.h>
+#include <driverlib/interrupt.h>
+#include <driverlib/uart.h>
+#include "uart-init.h"
+#include <utils/uartstdio.h>
+#include "arena.h"
+#include "os.h"
+#include "os-queue.h"
+#include "os-stream-buffer.h"
+
+#include "kernel-shell.h"
+
+typedef struct ShellObject
+{
+    const char *name;
+    int32_t *semaphore; // null for queues
+    OS_Queue *queue;    // null for semaphores
+} ShellObject;
+
+static ShellObject objects[KERNELSHELL_MAXOBJECTS];
+static uint32_t objectsLen = 0;
+
+//
+// Bytes received by the RX interrupt, waiting for the shell thread.
+// The shell thread is woken up for every byte, so that it can echo it.
+//
+OS_STREAM_BUFFER_DEFINE(rxStream, 64, 1, OS_STREAMBUFFER_NO_DELIMITER);
+
+//
+// Scratch memory of the shell thread, reset after every command.
+//
+ARENA_DEFINE(shellScratch, KERNELSHELL_SCRATCH);
+
+//
+// The fn uartRxIntHandler is called when the RX FIFO is half full, or when
+//   bytes have been sitting in it for a while (receive timeout).
+// It drains the FIFO into `rxStream` and returns: if the stream buffer is
+//   full, the bytes are dropped rather than waiting for the shell thread.
+//
+static void uartRxIntHandler(void);
+
+//
+// The fn shellThread reads a command line, echoing it, and executes it.
+//
+static void shellThread(void);
+static void commandExecute(char *line);
+
+static void psCommand(void);
+static void semCommand(void);
+static void prioCommand(char *name, char *priority);
+static void helpCommand(void);
+
+//
+// The fn waitPrint prints what the thread is waiting on: the registered
+//   name of the semaphore it is blocked on, or the remaining sleep in ms.
+//
+static void waitPrint(TCB *thread);
+
+//
+// The fn stateGet returns the thread's state padded to 8 characters, as
+//   UARTprintf can't left-justify strings.
+//
+static const char *stateGet(TCB *thread);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void KernelShell_Init(void)
+{
+    UART_Init();
+    UARTIntRegister(UART0_BASE, uartRxIntHandler);
+    UARTIntEnable(UART0_BASE, UART_INT_RX | UART_INT_RT);
+    OS_ERRCHECK(OS_ThreadCreate(shellThread, KERNELSHELL_PRIORITY, "kernelShell"));
+}
+
+void KernelShell_SemaphoreRegister(const char *name, int32_t *semaphore)
+{
+    ASSERT(objectsLen < KERNELSHELL_MAXOBJECTS);
+    objects[objectsLen].name = name;
+    objects[objectsLen].semaphore = semaphore;
+    objects[objectsLen].queue = 0;
+    objectsLen++;
+}
+
+void KernelShell_QueueRegister(const char *name, OS_Queue *queue)
+{
+    ASSERT(objectsLen < KERNELSHELL_MAXOBJECTS);
+    objects[objectsLen].name = name;
+    objects[objectsLen].semaphore = 0;
+    objects[objectsLen].queue = queue;
+    objectsLen++;
+}
+
+static void uartRxIntHandler(void)
+{
+    UARTIntClear(UART0_BASE, UARTIntStatus(UART0_BASE, true));
+    uint8_t bytes[16];
+    uint32_t len = 0;
+    while (UARTCharsAvail(UART0_BASE) && (len < sizeof(bytes)))
+    {
+        bytes[len++] = UARTCharGetNonBlocking(UART0_BASE);
+    }
+    OS_StreamBufferWrite(&rxStream, bytes, len);
+}
+
+static void shellThread(void)
+{
+    static char line[KERNELSHELL_LINELEN];
+    uint32_t lineLen = 0;
+    OS_ThreadArenaSet(OS_ThreadSelfGet(), &shellScratch);
+    UARTprintf("\nkernel shell, type `help`\n> ");
+    while (1)
+    {
+        uint8_t bytes[16];
+        uint32_t len = OS_StreamBufferRead(&rxStream, bytes, sizeof(bytes));
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            char c = bytes[idx];
+            if ((c == '\r') || (c == '\n'))
+            {
+                UARTprintf("\n");
+                line[lineLen] = '\0';
+                commandExecute(line);
+                lineLen = 0;
+                UARTprintf("> ");
+            }
+            else if ((c == '\b') || (c == 0x7F))
+            {
+                if (lineLen > 0)
+                {
+                    lineLen--;
+                    UARTprintf("\b \b");
+                }
+            }
+            else if (lineLen < KERNELSHELL_LINELEN - 1)
+            {
+                line[lineLen++] = c;
+                UARTprintf("%c", c);
+            }
+        }
+    }
+}
+
+static void commandExecute(char *line)
+{
+    char *command = strtok(line, " ");
+    char *arg0 = strtok(0, " ");
+    char *arg1 = strtok(0, " ");
+    if (command == 0)
+        return;
+
+    Arena *scratch = OS_ThreadArenaGet();
+    ArenaMark mark = Arena_Mark(scratch);
+    if (strcmp(command, "ps") == 0)
+        psCommand();
+    else if (strcmp(command, "sem") == 0)
+        semCommand();
+    else if (strcmp(command, "prio") == 0)
+        prioCommand(arg0, arg1);
+    else if (strcmp(command, "help") == 0)
+        helpCommand();
+    else
+        UARTprintf("unknown command `%s`, type `help`\n", command);
+    Arena_Reset(scratch, mark);
+}
+
+static void psCommand(void)
+{
+    TCB **threads = Arena_Alloc(OS_ThreadArenaGet(), KERNELSHELL_MAXTHREADS * sizeof(TCB *));
+    ASSERT(threads != 0);
+    uint32_t threadsLen = OS_ThreadsGet(threads, KERNELSHELL_MAXTHREADS);
+    UARTprintf("state    prio base stack    cpu%% wait         name\n");
+    for (uint32_t idx = 0; idx < threadsLen; idx++)
+    {
+        TCB *thread = threads[idx];
+        if (thread->status == TCBStateFree)
+            continue;
+
+        UARTprintf("%s %4u %4u %3u/%3u ",
+                   stateGet(thread), thread->priority, thread->basePriority,
+                   OS_ThreadStackUnusedGet(thread), thread->stackSize);
+#if OS_CONFIG_SLEEP && OS_CONFIG_CYCLES_ACCOUNTING
+        UARTprintf("%3u%% ", OS_ThreadCpuPercentGet(thread));
+#else
+        UARTprintf("   - ");
+#endif
+        waitPrint(thread);
+        UARTprintf("%s\n", thread->name);
+    }
+#if OS_CONFIG_SLEEP && OS_CONFIG_CYCLES_ACCOUNTING
+    UARTprintf("idle %u%%\n", OS_GetIdlePercent());
+#endif
+    UARTprintf("switches from ISRs %u, saved %u\n",
+               OS_ISRSwitchesPendedGet(), OS_ISRSwitchesSavedGet());
+}
+
+static void semCommand(void)
+{
+    for (uint32_t idx = 0; idx < objectsLen; idx++)
+    {
+        ShellObject *object = &objects[idx];
+        if (object->semaphore != 0)
+        {
+            UARTprintf("semaphore %4d     %s\n", *object->semaphore, object->name);
+        }
+        else
+        {
+            UARTprintf("queue     %4d/%4u %s\n",
+                       object->queue->currentSize, object->queue->capacity, object->name);
+        }
+    }
+}
+
+static void prioCommand(char *name, char *priority)
+{
+#if OS_CONFIG_PRIORITY_SCHEDULER
+    if ((name == 0) || (priority == 0))
+    {
+        UARTprintf("usage: prio <name> <0-255>\n");
+        return;
+    }
+    char *end;
+    uint32_t value = strtoul(priority, &end, 10);
+    if ((end == priority) || (*end != '\0'))
+    {
+        UARTprintf("priority `%s` isn't a number\n", priority);
+        return;
+    }
+    if (value > 255) // negative numbers wrap around, and end up here too
+    {
+        UARTprintf("priority out of range\n");
+        return;
+    }
+    TCB **threads = Arena_Alloc(OS_ThreadArenaGet(), KERNELSHELL_MAXTHREADS * sizeof(TCB *));
+    ASSERT(threads != 0);
+    uint32_t threadsLen = OS_ThreadsGet(threads, KERNELSHELL_MAXTHREADS);
+    for (uint32_t idx = 0; idx < threadsLen; idx++)
+    {
+        if ((threads[idx]->status == TCBStateActive) && (strcmp(threads[idx]->name, name) == 0))
+        {
+            OS_ThreadSetPriority(threads[idx], value);
+            return;
+        }
+    }
+    UARTprintf("no thread `%s`\n", name);
+#else
+    UARTprintf("priorities need OS_CONFIG_PRIORITY_SCHEDULER\n");
+#endif
+}
+
+static void helpCommand(void)
+{
+    UARTprintf("ps                 list threads\n");
+    UARTprintf("sem                list semaphores and queues\n");
+    UARTprintf("prio <name> <n>    set a thread's priority\n");
+}
+
+static void waitPrint(TCB *thread)
+{
+    int32_t *s = thread->blocked;
+    if (s == 0)
+    {
+        if (thread->sleep != 0)
+            UARTprintf("%4ums       ", thread->sleep);
+        else
+            UARTprintf("-            ");
+        return;
+    }
+    for (uint32_t idx = 0; idx < objectsLen; idx++)
+    {
+        ShellObject *object = &objects[idx];
+        if (object->semaphore == s)
+        {
+            UARTprintf("%s ", object->name);
+            return;
+        }
+        if ((object->queue != 0) && (&object->queue->currentSize == s))
+        {
+            UARTprintf("%s.items ", object->name);
+            return;
+        }
+        if ((object->queue != 0) && (&object->queue->roomLeft == s))
+        {
+            UARTprintf("%s.room ", object->name);
+            return;
+        }
+    }
+    UARTprintf("0x%08x   ", (uint32_t)s);
+}
+
+static const char *stateGet(TCB *thread)
+{
+    if (thread->blocked != 0)
+        return "blocked ";
+    if (thread->sleep != 0)
+        return "sleep   ";
+    if (thread == OS_ThreadSelfGet())
+        return "run     ";
+    return "ready   ";
+}
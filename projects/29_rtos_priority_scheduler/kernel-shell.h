@@ -0,0 +1,64 @@
+//*****************************************************************************
+//
+// Kernel introspection shell on UART0, to look at the threads of a running
+//   board without a debugger.
+//
+// The shell runs in its own thread at the lowest priority, so it only gets
+//   the CPU time the other threads leave. The RX interrupt just moves the
+//   received bytes into a stream buffer, without ever blocking; the shell
+//   thread is woken up by the stream buffer and echoes them back.
+//
+// Commands:
+//   ps                 threads: state, priority, stack, CPU%, what they wait on
+//   sem                values of the registered semaphores and queues
+//   prio <name> <n>    change the priority of a thread
+//   help               list the commands
+//
+// `ps` prints one line per thread, in the form:
+//
+//     state    prio base stack    cpu% wait         name
+//     blocked     3    3  62/100    0% GPIOPB6      userTaskOnPB6RisingEdgeThread
+//
+// where `stack` is the high-water mark, that is, the words never used out
+//   of the stack's size, and `wait` is the remaining sleep in ms, or the
+//   semaphore the thread is blocked on.
+// Semaphores and queues are shown by name only if they were registered.
+// The shell thread has its own arena, see `arena.h`, for the scratch memory
+//   of a command, released at once when the command is done.
+//
+// Usage:
+// ```c
+// #include "kernel-shell.h"
+//
+// OS_Init(THREADFREQ, userTask0, 5, "userTask0");
+// KernelShell_Init();
+// KernelShell_SemaphoreRegister("GPIOPB6", &GPIOPB6_Signal_RisingEdgeHit);
+// KernelShell_QueueRegister("adcQueue", &adcQueue); // as `adcQueue.items` and `adcQueue.room`
+// OS_Launch();
+// ```
+//
+//*****************************************************************************
+
+#ifndef KERNEL_SHELL_H_INCLUDED
+#define KERNEL_SHELL_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+#include "os-queue.h"
+
+#if !OS_CONFIG_SEMAPHORES
+#error "The kernel shell needs OS_CONFIG_SEMAPHORES, see os-config.h"
+#endif
+
+#define KERNELSHELL_PRIORITY 254   // just above the idle thread
+#define KERNELSHELL_MAXOBJECTS 8   // maximum number of registered semaphores and queues
+#define KERNELSHELL_MAXTHREADS 16  // maximum number of threads listed by `ps`
+#define KERNELSHELL_LINELEN 32     // bytes of a command line, including '\0'
+#define KERNELSHELL_SCRATCH 128    // bytes of scratch memory for a command
+
+void KernelShell_Init(void);
+void KernelShell_SemaphoreRegister(const char *name, int32_t *semaphore);
+void KernelShell_QueueRegister(const char *name, OS_Queue *queue);
+
+#endif
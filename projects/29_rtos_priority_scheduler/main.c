@@ -1,12 +1,38 @@
 //******************************************************************************
 //
 // Implement a priority scheduler.
-// Then run an event thread as high priority main thread.
+// Then run an event thread, at the priority of the main threads, boosted
+//   when woken up by its ISR.
 // In short:
 //   * the event thread blocks waiting for a semaphore;
-//   * the ISR signals the semaphore and suspends the current main thread;
-//   * because the event thread has high priority and isn't blocked anymore,
-//       the scheduler runs it immediately.
+//   * the ISR signals the semaphore with `OS_SemaphoreSignalFromISR`;
+//   * because the event thread is boosted above the main threads, see
+//       `OS_ThreadSetBoost`, a switch is pended, and the scheduler runs it
+//       as soon as the ISR returns; without the boost, it would wait for
+//       its turn in the round-robin;
+//   * the boost ends with its first time-slice, so its long-running task
+//       then shares the processor with the main threads.
+// When every thread is either sleeping or blocked, the kernel falls back to
+//   its idle thread, which puts the processor to sleep and measures the idle
+//   time returned by `OS_GetIdlePercent`.
+// The event thread is defined at compile time with `OS_THREAD_DEFINE`, so
+//   that its TCB and stack are already initialized when `main` runs.
+// The switches on PB5 and on SW1 (PF4) are debounced by a periodic tick,
+//   see `port-debounce.h`; each press toggles the onboard blue LED on PF2,
+//   from an event task sharing the stack of the kernel's event dispatcher,
+//   see `os-event-tasks.h`.
+// A low-priority shell on UART0 lists the threads, the semaphores, and
+//   changes priorities at runtime, see `kernel-shell.h`.
+// userTask0 and userTask2 check in with the watchdog supervisor: if either
+//   misses its deadline, the board resets, and the name of the thread is
+//   printed on UART0 at the next startup, see `watchdog-supervisor.h`.
+// Every 5 seconds, a thread reads the temperature from the SHT21 sensor of
+//   project 25 on I2C0 (PB2 SCL, PB3 SDA), and prints it on UART0; it's
+//   blocked while the bytes are on the bus, see `i2c0pb23-async.h`.
+// Define `KERNEL_BENCHMARK` to run the kernel micro-benchmarks instead,
+//   see `kernel-benchmark.h`.
+// Define `WCET_PROBE` to measure the WCETs of the threads in `threadset.txt`,
+//   see `wcet-probe.h`.
 //
 // The program can be tried by connecting a positive logic switch to PB6.
 // The event thread blinks the onboard red LED on PF1.
@@ -15,6 +41,8 @@
 //
 // Changes in `os.h`, `gpiopb6-signal.h`, `user-tasks.h`, and `blinky.h`.
 //
+// The kernel is the one in `rtos/`, configured by `os-config.h`.
+//
 // For reference:
 //   book "Real-Time Operating Systems for ARM Cortex-M Microcontrollers"
 //   from page 237 to page 240.
@@ -25,10 +53,19 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <inc/hw_memmap.h>
 #include <driverlib/debug.h>
+#include <driverlib/gpio.h>
+#include <driverlib/sysctl.h>
+#include <utils/uartstdio.h>
 #include "os.h"
 #include "user-tasks.h"
 #include "gpiopb6-signal.h"
+#include "i2c0pb23-async.h"
+#include "kernel-benchmark.h"
+#include "kernel-shell.h"
+#include "port-debounce.h"
+#include "watchdog-supervisor.h"
 
 #ifdef DEBUG
 void __error__(char *pcFilename, uint32_t ui32Line)
@@ -38,19 +75,45 @@ void __error__(char *pcFilename, uint32_t ui32Line)
 }
 #endif
 
+#ifndef KERNEL_BENCHMARK
+OS_THREAD_DEFINE(userTaskOnPB6RisingEdgeThread, userTaskOnPB6RisingEdge, 5, STACKSIZE);
+OS_THREAD_DEFINE(userTaskSensorThread, userTaskSensor, 4, STACKSIZE);
+#endif
+
 int main(void)
 {
+#ifdef KERNEL_BENCHMARK
+    KernelBenchmark_Init();
+    OS_Launch();
+#endif
+
     //
     // Initialize OS and threads.
     //
     OS_Init(THREADFREQ, userTask0, 5, "userTask0");
     OS_ERRCHECK(OS_ThreadCreate(userTask1, 5, "userTask1"));
-    OS_ERRCHECK(OS_ThreadCreate(userTaskOnPB6RisingEdge, 3, "userTaskOnPB6RisingEdge"));
+#ifndef KERNEL_BENCHMARK
+    OS_ThreadSetBoost(&userTaskOnPB6RisingEdgeThread, 3);
+#endif
 
     //
     // Initialize other resources.
     //
     GPIOPB6_Signal_Init();
+    I2C0PB23Async_Init();
+    userTaskOnButtonsCreate();
+    PortDebounce_InitEventTask(5, &buttonTask);
+    PortDebounce_PortAdd(SYSCTL_PERIPH_GPIOB, GPIO_PORTB_BASE, GPIO_PIN_5, false);
+    PortDebounce_PortAdd(SYSCTL_PERIPH_GPIOF, GPIO_PORTF_BASE, GPIO_PIN_4, true);
+    PortDebounce_Enable();
+    KernelShell_Init();
+    KernelShell_SemaphoreRegister("GPIOPB6_Signal_RisingEdgeHit", &GPIOPB6_Signal_RisingEdgeHit);
+    WatchdogSupervisor_Report report;
+    if (WatchdogSupervisor_ReportGet(&report))
+    {
+        UARTprintf("Reset by the watchdog: `%s` overdue by %dms\n", report.threadName, report.overdueMs);
+    }
+    WatchdogSupervisor_Init(500);
 
     //
     // Launch OS.
@@ -0,0 +1,19 @@
+//*****************************************************************************
+//
+// Kernel features used by this project; see `rtos/os.h`.
+// The whole kernel.
+//
+//*****************************************************************************
+
+#ifndef OS_CONFIG_H_INCLUDED
+#define OS_CONFIG_H_INCLUDED
+
+#define OS_CONFIG_PRIORITY_SCHEDULER 1
+#define OS_CONFIG_SEMAPHORES 1
+#define OS_CONFIG_SLEEP 1
+#define OS_CONFIG_THREAD_CREATE_KILL 1
+#define OS_CONFIG_STACK_GUARD 1
+#define OS_CONFIG_CYCLES_ACCOUNTING 1
+#define OS_CONFIG_EVENT_TASKS 1
+
+#endif
@@ -0,0 +1,155 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <inc/hw_memmap.h>
+#include <driverlib/debug.h>
+#include <driverlib/gpio.h>
+#include <driverlib/sysctl.h>
+#include <driverlib/timer.h>
+#include "macro-utils.h"
+#include "vertical-debounce.h"
+#include "os.h"
+#include "os-event-tasks.h"
+#include "os-queue.h"
+
+#include "port-debounce.h"
+
+typedef struct DebouncedPort
+{
+    uint32_t portBase;
+    uint8_t pins;
+    uint8_t invertMask; // pins in negative logic
+} DebouncedPort;
+
+static DebouncedPort ports[PORTDEBOUNCE_MAXPORTS];
+static uint32_t portsLen = 0;
+static VerticalDebounce debounce;
+static OS_Queue *eventsQueue;
+#if OS_CONFIG_EVENT_TASKS
+static OS_EventTask *eventsTask;
+#endif
+static uint32_t droppedEvents = 0;
+
+//
+// The fn portsSample reads all the ports, and packs their pins into a
+//   word, one byte per port, with 1 meaning pressed.
+//
+static uint32_t portsSample(void);
+
+//
+// The fn timerInit sets Timer2 to tick every `periodMs`, without starting it.
+//
+static void timerInit(uint32_t periodMs);
+
+//
+// The fn eventPost posts an event to the queue or to the event task, and
+//   returns false if it was full.
+//
+static bool eventPost(PortDebounce_Event event);
+
+//
+// The fn tickIntHandler is called by Timer2 every `periodMs`.
+// It feeds the sample to the vertical counters and posts an event for
+//   every switch whose debounced state toggled; usually there are none.
+//
+static void tickIntHandler(void);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void PortDebounce_Init(uint32_t periodMs, OS_Queue *events)
+{
+    eventsQueue = events;
+    timerInit(periodMs);
+}
+
+#if OS_CONFIG_EVENT_TASKS
+void PortDebounce_InitEventTask(uint32_t periodMs, OS_EventTask *task)
+{
+    eventsTask = task;
+    timerInit(periodMs);
+}
+#endif
+
+uint32_t PortDebounce_PortAdd(uint32_t peripheral, uint32_t portBase, uint8_t pins, bool isNegativeLogic)
+{
+    ASSERT(portsLen < PORTDEBOUNCE_MAXPORTS);
+    SysCtlPeripheralEnableAndReady(peripheral);
+    GPIOPinTypeGPIOInput(portBase, pins);
+    if (isNegativeLogic)
+    {
+        GPIOPadConfigSet(portBase, pins, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
+    }
+
+    uint32_t slot = portsLen;
+    ports[slot].portBase = portBase;
+    ports[slot].pins = pins;
+    ports[slot].invertMask = isNegativeLogic ? pins : 0;
+    portsLen++;
+    return slot;
+}
+
+void PortDebounce_Enable(void)
+{
+    // start from the current state, so that switches already pressed
+    //   at startup don't generate events
+    VerticalDebounce_Init(&debounce, portsSample());
+    TimerEnable(TIMER2_BASE, TIMER_A);
+}
+
+uint32_t PortDebounce_DroppedGet(void)
+{
+    return droppedEvents;
+}
+
+static void timerInit(uint32_t periodMs)
+{
+    SysCtlPeripheralEnableAndReady(SYSCTL_PERIPH_TIMER2);
+    TimerConfigure(TIMER2_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER2_BASE, TIMER_A, (SysCtlClockGet() / 1000) * periodMs);
+    TimerIntRegister(TIMER2_BASE, TIMER_A, tickIntHandler);
+    TimerIntEnable(TIMER2_BASE, TIMER_TIMA_TIMEOUT);
+}
+
+static bool eventPost(PortDebounce_Event event)
+{
+#if OS_CONFIG_EVENT_TASKS
+    if (eventsTask != 0)
+    {
+        return OS_EventTaskPost(eventsTask, PORTDEBOUNCE_EVENTWORD(event)) == OS_ERR_NONE;
+    }
+#endif
+    return OS_QueueTryPut(eventsQueue, &event) == OS_ERR_NONE;
+}
+
+static uint32_t portsSample(void)
+{
+    uint32_t sample = 0;
+    for (uint32_t slot = 0; slot < portsLen; slot++)
+    {
+        uint32_t pinsRead = GPIOPinRead(ports[slot].portBase, ports[slot].pins);
+        sample |= ((pinsRead ^ ports[slot].invertMask) & ports[slot].pins) << (slot * 8);
+    }
+    return sample;
+}
+
+static void tickIntHandler(void)
+{
+    TimerIntClear(TIMER2_BASE, TIMER_TIMA_TIMEOUT);
+    uint32_t toggled = VerticalDebounce_Update(&debounce, portsSample());
+    for (uint32_t input = 0; toggled != 0; input++, toggled >>= 1)
+    {
+        if ((toggled & 1) == 0)
+            continue;
+
+        PortDebounce_Event event = {
+            .input = input,
+            .isPressed = (debounce.state & (1u << input)) != 0};
+        if (!eventPost(event))
+        {
+            droppedEvents++;
+        }
+    }
+}
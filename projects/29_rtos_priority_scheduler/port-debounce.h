@@ -0,0 +1,77 @@
+//*****************************************************************************
+//
+// Debounce up to 32 switches, on up to 4 GPIO ports, from a single periodic
+//   Timer2 interrupt, and post their press and release events to a queue.
+//
+// At every tick, each port is read once, all of its pins together, and the
+//   samples are packed into a 32-bit word, one byte per port: the switch on
+//   pin `n` of the port added as `slot` is input `slot * 8 + n`.
+// The word goes through the vertical counters of `vertical-debounce.h`, so
+//   a switch is reported after 4 equal samples, whatever the number of
+//   switches, at the cost of a few instructions per tick.
+//
+// Events are posted with `OS_QueueTryPut`: if the queue is full, they are
+//   dropped, and counted in `PortDebounce_DroppedGet`.
+// With `PortDebounce_InitEventTask`, they are posted to an event task
+//   instead, see `os-event-tasks.h`, packed in the event's word by
+//   `PORTDEBOUNCE_EVENTWORD`; a full queue drops them the same way.
+// Unlike the edge-triggered `SwitchDebouncePB5` of project 28, no thread
+//   is needed, and bounces cause no interrupts at all.
+//
+// Usage:
+// ```c
+// #include "port-debounce.h"
+//
+// OS_QUEUE_DEFINE(buttonEvents, PortDebounce_Event, 8);
+//
+// PortDebounce_Init(5, &buttonEvents);                       // 20ms of debouncing
+// PortDebounce_PortAdd(SYSCTL_PERIPH_GPIOB, GPIO_PORTB_BASE,
+//                      GPIO_PIN_5 | GPIO_PIN_7, false);       // slot 0, positive logic
+// PortDebounce_PortAdd(SYSCTL_PERIPH_GPIOF, GPIO_PORTF_BASE,
+//                      GPIO_PIN_4, true);                     // slot 1, SW1, negative logic
+// PortDebounce_Enable();
+//
+// PortDebounce_Event event;
+// OS_QueueGet(&buttonEvents, &event); // event.input == 12 for SW1
+//
+// void onButton(uint32_t event)
+// {
+//     PortDebounce_Event buttonEvent = PORTDEBOUNCE_EVENT(event);
+// }
+// OS_EventTaskCreate(&buttonTask, onButton, 0, buttonTaskEvents, 8);
+// PortDebounce_InitEventTask(5, &buttonTask);
+// ```
+//
+//*****************************************************************************
+
+#ifndef PORT_DEBOUNCE_H_INCLUDED
+#define PORT_DEBOUNCE_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+#include "os-event-tasks.h"
+#include "os-queue.h"
+
+#define PORTDEBOUNCE_MAXPORTS 4 // one byte of the 32-bit sample each
+
+typedef struct PortDebounce_Event
+{
+    uint8_t input;  // slot * 8 + pin number
+    bool isPressed; // false when released
+} PortDebounce_Event;
+
+// Conversions between an event and the word posted to an event task.
+#define PORTDEBOUNCE_EVENTWORD(event) ((event).input | ((uint32_t)(event).isPressed << 8))
+#define PORTDEBOUNCE_EVENT(word) \
+    ((PortDebounce_Event){.input = (word) & 0xFF, .isPressed = ((word) & 0x100) != 0})
+
+void PortDebounce_Init(uint32_t periodMs, OS_Queue *events);
+#if OS_CONFIG_EVENT_TASKS
+void PortDebounce_InitEventTask(uint32_t periodMs, OS_EventTask *task);
+#endif
+uint32_t PortDebounce_PortAdd(uint32_t peripheral, uint32_t portBase, uint8_t pins, bool isNegativeLogic);
+void PortDebounce_Enable(void);
+uint32_t PortDebounce_DroppedGet(void);
+
+#endif
@@ -1,57 +1,26 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "os.h"
+#include "os-queue.h"
 
 #include "semaphore-fifo.h"
 
 static uint32_t fifo[FIFO_SIZE];
-
-static volatile uint32_t *putPt;
-static volatile uint32_t *getPt;
-
-static int32_t currentSize;
-static int32_t roomLeft;
-static int32_t fifoMutex;
+static OS_Queue fifoQueue;
 
 void SemaphoreFifo_Init(void)
 {
-    putPt = getPt = &fifo[0];
-    currentSize = 0;
-    roomLeft = FIFO_SIZE;
-    fifoMutex = 1;
+    OS_QueueInit(&fifoQueue, fifo, sizeof(uint32_t), FIFO_SIZE);
 }
 
 void SemaphoreFifo_Put(uint32_t data)
 {
-    OS_SemaphoreWait(&roomLeft);
-    OS_SemaphoreWait(&fifoMutex);
-
-    *putPt = data;
-    putPt++;
-    if (putPt == &fifo[FIFO_SIZE])
-    {
-        // wrap
-        putPt = &fifo[0];
-    }
-
-    OS_SemaphoreSignal(&fifoMutex);
-    OS_SemaphoreSignal(&currentSize);
+    OS_QueuePut(&fifoQueue, &data);
 }
 
 uint32_t SemaphoreFifo_Get(void)
 {
-    OS_SemaphoreWait(&currentSize);
-    OS_SemaphoreWait(&fifoMutex);
-
-    uint32_t data = *getPt;
-    getPt++;
-    if (getPt == &fifo[FIFO_SIZE])
-    {
-        // wrap
-        getPt = &fifo[0];
-    }
-
-    OS_SemaphoreSignal(&fifoMutex);
-    OS_SemaphoreSignal(&roomLeft);
+    uint32_t data;
+    OS_QueueGet(&fifoQueue, &data);
     return data;
 }
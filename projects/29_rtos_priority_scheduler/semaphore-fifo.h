@@ -4,6 +4,9 @@
 //   multiple consumer threads.
 // Producers will suspend (`OS_SemaphoreWait`) when the FIFO is full, and
 //   consumers will suspend (`OS_SemaphoreWait`) when the FIFO is empty.
+// It's a single global instance of `OS_Queue`; see `os-queue.h` for queues
+//   with custom storage, element size, and capacity, and `os-stream-buffer.h`
+//   for streams of bytes, e.g. from the UART.
 //
 // Usage:
 // ```c
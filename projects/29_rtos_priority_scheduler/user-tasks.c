@@ -1,20 +1,43 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <driverlib/sysctl.h>
+#include <utils/uartstdio.h>
 #include "instrument-trigger.h"
 #include "os.h"
 #include "gpiopb6-signal.h"
+#include "i2c0pb23-async.h"
+#include "port-debounce.h"
+#include "watchdog-supervisor.h"
+#include "wcet-probe.h"
 
 #include "user-tasks.h"
 
+// Long enough for the event thread to run its long task twice meanwhile,
+//   about a second each, the most a bouncy press of PB6 can queue.
+#define WATCHDOG_DEADLINE_MS 3000
+
+#define SHT21_SENSOR_I2C_ADDRESS 0x40
+#define SHT21_TRIGGER_T_MEASUREMENT_NHM 0xF3 // command trig. temperature measurement
+#define SHT21_T_MEASUREMENT_MS 85
+#define SHT21_TRANSFER_TIMEOUT_MS 10 // a few bytes at 100kbps take well under 1ms
+
+// With `WCET_PROBE` defined, the jobs of the threads in `threadset.txt` are
+//   measured, and the sensor's thread prints the WCETs every 5 seconds.
+WCETPROBE_DEFINE(userTask2Probe, "userTask2");
+WCETPROBE_DEFINE(userTaskOnPB6RisingEdgeProbe, "userTaskOnPB6RisingEdgeThread");
+WCETPROBE_DEFINE(userTaskOnButtonsProbe, "OS_EventTasks");
+WCETPROBE_DEFINE(userTaskSensorProbe, "userTaskSensorThread");
+
 InstrumentTrigger_Create(E, 0);
 void userTask0(void)
 {
     InstrumentTriggerPE0_Init();
+    uint32_t watchdogHandle = WatchdogSupervisor_Register(WATCHDOG_DEADLINE_MS);
     uint32_t count = 0;
     while (1)
     {
         count++;
+        WatchdogSupervisor_CheckIn(watchdogHandle);
         InstrumentTriggerPE0_Toggle();
         SysCtlDelay(100);
 
@@ -25,6 +48,7 @@ void userTask0(void)
 
         if (count == 10000)
         {
+            WatchdogSupervisor_Unregister(watchdogHandle);
             OS_ERRCHECK(OS_ThreadKill());
         }
     }
@@ -49,13 +73,20 @@ InstrumentTrigger_Create(E, 2);
 void userTask2(void)
 {
     InstrumentTriggerPE2_Init();
+    uint32_t watchdogHandle = WatchdogSupervisor_Register(WATCHDOG_DEADLINE_MS);
     uint32_t count = 0;
+    uint32_t lastWakeTicks = OS_TicksGet();
+    WcetProbe_Start(&userTask2Probe);
     while (1)
     {
         count++;
         if (count % 125 == 0)
         {
-            OS_ThreadSleep(50);
+            // a burst of toggles every 50ms, regardless of the burst's duration
+            WcetProbe_Stop(&userTask2Probe);
+            OS_ThreadSleepUntil(&lastWakeTicks, 50);
+            WcetProbe_Start(&userTask2Probe);
+            WatchdogSupervisor_CheckIn(watchdogHandle);
         }
 
         InstrumentTriggerPE2_Toggle();
@@ -71,6 +102,7 @@ void userTaskOnPB6RisingEdge(void)
     while (1)
     {
         OS_SemaphoreWait(&GPIOPB6_Signal_RisingEdgeHit);
+        WcetProbe_Start(&userTaskOnPB6RisingEdgeProbe);
 
         // some long-running task
         for (uint32_t idx = 0; idx < 4; idx++)
@@ -78,5 +110,81 @@ void userTaskOnPB6RisingEdge(void)
             InstrumentTriggerPF1_Toggle();
             SysCtlDelay(clockRate / 12);
         }
+        WcetProbe_Stop(&userTaskOnPB6RisingEdgeProbe);
+    }
+}
+
+OS_EventTask buttonTask;
+static uint32_t buttonEvents[8];
+static void userTaskOnButtons(uint32_t event);
+InstrumentTrigger_Create(F, 2);
+void userTaskOnButtonsCreate(void)
+{
+    InstrumentTriggerPF2_Init();
+    OS_EventTaskCreate(&buttonTask, userTaskOnButtons, 0, buttonEvents, 8);
+}
+
+// an event task: run to completion on the dispatcher's stack, once per event
+static void userTaskOnButtons(uint32_t event)
+{
+    WcetProbe_Start(&userTaskOnButtonsProbe);
+    if (PORTDEBOUNCE_EVENT(event).isPressed)
+    {
+        InstrumentTriggerPF2_Toggle();
+    }
+    WcetProbe_Stop(&userTaskOnButtonsProbe);
+}
+
+//
+// The fn sensorAwait waits for a transfer with the sensor, and cancels it
+//   if the bus is stuck, so that the buffer can be reused.
+//
+static OS_Err sensorAwait(OS_Future *transfer)
+{
+    OS_Err err = OS_AwaitTimeout(transfer, SHT21_TRANSFER_TIMEOUT_MS);
+    if (err == OS_ERR_TIMEOUT)
+    {
+        I2C0PB23Async_Cancel(transfer);
+    }
+    return err;
+}
+
+void userTaskSensor(void)
+{
+    OS_Future transfer;
+    uint32_t lastWakeTicks = OS_TicksGet();
+    while (1)
+    {
+        OS_ThreadSleepUntil(&lastWakeTicks, 5000);
+        WcetProbe_Start(&userTaskSensorProbe);
+
+        // the thread is blocked while the bytes are on the bus
+        uint8_t command = SHT21_TRIGGER_T_MEASUREMENT_NHM;
+        uint8_t reading[3]; // MSB, LSB, checksum
+        if (sensorAwait(I2C0PB23Async_BurstSend(SHT21_SENSOR_I2C_ADDRESS, &command, 1, &transfer)) != OS_ERR_NONE)
+        {
+            UARTprintf("Sensor not responding\n");
+            continue;
+        }
+        OS_ThreadSleep(SHT21_T_MEASUREMENT_MS);
+        if (sensorAwait(I2C0PB23Async_BurstReceive(SHT21_SENSOR_I2C_ADDRESS, reading, 3, &transfer)) != OS_ERR_NONE)
+        {
+            UARTprintf("Sensor not responding\n");
+            continue;
+        }
+
+        // same formula as project 25, in hundredths of a degree
+        int32_t rawReading = ((reading[0] << 8) | reading[1]) & ~0x03;
+        int32_t temperature = -4685 + ((17572 * rawReading) >> 16);
+        const char *sign = (temperature < 0) ? "-" : "";
+        if (temperature < 0)
+            temperature = -temperature;
+        UARTprintf("Temperature: %s%d.%02d\n", sign, temperature / 100, temperature % 100);
+        WcetProbe_Stop(&userTaskSensorProbe);
+
+        WcetProbe_Print(&userTask2Probe);
+        WcetProbe_Print(&userTaskOnPB6RisingEdgeProbe);
+        WcetProbe_Print(&userTaskOnButtonsProbe);
+        WcetProbe_Print(&userTaskSensorProbe);
     }
 }
@@ -1,9 +1,15 @@
 #ifndef USER_TASKS_H_INCLUDED
 #define USER_TASKS_H_INCLUDED
 
+#include "os-event-tasks.h"
+
+extern OS_EventTask buttonTask;
+
 void userTask0(void);
 void userTask1(void);
 void userTask2(void);
 void userTaskOnPB6RisingEdge(void);
+void userTaskOnButtonsCreate(void);
+void userTaskSensor(void);
 
 #endif
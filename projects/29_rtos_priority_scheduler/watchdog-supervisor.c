@@ -0,0 +1,141 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inc/hw_ints.h>
+#include <inc/hw_memmap.h>
+#include <driverlib/debug.h>
+#include <driverlib/interrupt.h>
+#include <driverlib/sysctl.h>
+#include <driverlib/watchdog.h>
+#include "macro-utils.h"
+#include "os.h"
+
+#include "watchdog-supervisor.h"
+
+#define REPORT_MAGIC 0x5744474F // "WDGO"
+
+typedef struct CheckIn
+{
+    TCB *tcb; // 0 while the slot is free
+    uint32_t deadlineMs;
+    volatile uint32_t lastCheckInTicks;
+} CheckIn;
+
+static CheckIn checkIns[WATCHDOGSUPERVISOR_MAXTHREADS];
+static uint32_t checkInsLen = 0;
+
+//
+// Survives the watchdog reset: the `.os_noinit` section isn't touched
+//   by the startup code. See `blinky_ccs.cmd`.
+// `magic` tells whether `report` was written before the last reset.
+//
+typedef struct RetainedReport
+{
+    uint32_t magic;
+    WatchdogSupervisor_Report report;
+} RetainedReport;
+
+OS_SECTION(".os_noinit")
+static RetainedReport retained;
+
+//
+// The fn watchdogIntHandler is called every time the watchdog times out.
+// It feeds the watchdog only if all threads checked in within their deadline.
+// Otherwise it saves the report and lets the second timeout reset the board.
+//
+static void watchdogIntHandler(void);
+static void reportSave(CheckIn *checkIn, uint32_t overdueMs);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void WatchdogSupervisor_Init(uint32_t periodMs)
+{
+    SysCtlPeripheralEnableAndReady(SYSCTL_PERIPH_WDOG0);
+    WatchdogReloadSet(WATCHDOG0_BASE, (SysCtlClockGet() / 1000) * periodMs);
+    WatchdogIntRegister(WATCHDOG0_BASE, watchdogIntHandler);
+    WatchdogResetEnable(WATCHDOG0_BASE);
+    WatchdogStallEnable(WATCHDOG0_BASE); // Stop counting when the processor is stopped by the debugger
+    WatchdogEnable(WATCHDOG0_BASE);
+}
+
+uint32_t WatchdogSupervisor_Register(uint32_t deadlineMs)
+{
+    IntMasterDisable();
+    uint32_t handle = 0;
+    while ((handle < checkInsLen) && (checkIns[handle].tcb != 0))
+    {
+        handle++;
+    }
+    ASSERT(handle < WATCHDOGSUPERVISOR_MAXTHREADS);
+    checkIns[handle].deadlineMs = deadlineMs;
+    checkIns[handle].lastCheckInTicks = OS_TicksGet();
+    checkIns[handle].tcb = OS_ThreadSelfGet();
+    if (handle == checkInsLen)
+    {
+        checkInsLen++;
+    }
+    IntMasterEnable();
+    return handle;
+}
+
+void WatchdogSupervisor_Unregister(uint32_t handle)
+{
+    checkIns[handle].tcb = 0;
+}
+
+void WatchdogSupervisor_CheckIn(uint32_t handle)
+{
+    checkIns[handle].lastCheckInTicks = OS_TicksGet();
+}
+
+bool WatchdogSupervisor_ReportGet(WatchdogSupervisor_Report *report)
+{
+    bool isWatchdogReset = (SysCtlResetCauseGet() & SYSCTL_CAUSE_WDOG0) != 0;
+    bool isValid = isWatchdogReset && (retained.magic == REPORT_MAGIC);
+    if (isValid)
+    {
+        *report = retained.report;
+    }
+    retained.magic = 0;
+    SysCtlResetCauseClear(SYSCTL_CAUSE_WDOG0);
+    return isValid;
+}
+
+static void watchdogIntHandler(void)
+{
+    uint32_t now = OS_TicksGet();
+    for (uint32_t idx = 0; idx < checkInsLen; idx++)
+    {
+        if (checkIns[idx].tcb == 0)
+            continue;
+
+        uint32_t elapsedMs = now - checkIns[idx].lastCheckInTicks;
+        if ((checkIns[idx].tcb->status == TCBStateActive) &&
+            (elapsedMs > checkIns[idx].deadlineMs))
+        {
+            reportSave(&checkIns[idx], elapsedMs - checkIns[idx].deadlineMs);
+
+            // The interrupt stays asserted until the reset: stop handling it,
+            //   so that the other threads keep running in the meantime.
+            IntDisable(INT_WATCHDOG_TM4C123);
+            return;
+        }
+    }
+    WatchdogIntClear(WATCHDOG0_BASE);
+}
+
+static void reportSave(CheckIn *checkIn, uint32_t overdueMs)
+{
+    TCB *tcb = checkIn->tcb;
+    strncpy(retained.report.threadName, tcb->name, WATCHDOGSUPERVISOR_NAMELEN - 1);
+    retained.report.threadName[WATCHDOGSUPERVISOR_NAMELEN - 1] = '\0';
+    retained.report.overdueMs = overdueMs;
+    retained.report.sleep = tcb->sleep;
+    retained.report.blocked = (tcb->blocked != 0);
+    retained.report.priority = tcb->priority;
+    retained.magic = REPORT_MAGIC;
+}
@@ -0,0 +1,73 @@
+//*****************************************************************************
+//
+// Kernel-aware watchdog: every registered thread must check in within its
+//   own deadline, and the hardware watchdog is fed only if all of them did.
+//
+// The watchdog interrupt fires every `periodMs`, and checks the deadlines.
+// If a thread is overdue, the interrupt isn't cleared, so the watchdog resets
+//   the board at the next timeout. Before that, the offending thread's name
+//   and state are saved in the `.os_noinit` section, which isn't initialized
+//   at startup, and can be read back after the reset.
+// A thread must unregister before it's killed: its TCB can be reused by
+//   the next thread created, which would inherit its deadline.
+//
+// Usage:
+// ```c
+// #include "watchdog-supervisor.h"
+//
+// void userTask(void)
+// {
+//     uint32_t handle = WatchdogSupervisor_Register(100); // check in every 100ms
+//     while (1)
+//     {
+//         DoSomething();
+//         WatchdogSupervisor_CheckIn(handle);
+//         if (IsDone())
+//         {
+//             WatchdogSupervisor_Unregister(handle);
+//             OS_ThreadKill();
+//         }
+//     }
+// }
+//
+// int main(void)
+// {
+//     WatchdogSupervisor_Report report;
+//     OS_Init(THREADFREQ, userTask, 5, "userTask");
+//     if (WatchdogSupervisor_ReportGet(&report))
+//     {
+//         // the last reset was caused by `report.threadName`
+//     }
+//     WatchdogSupervisor_Init(500);
+//     OS_Launch();
+// }
+// ```
+//
+//*****************************************************************************
+
+#ifndef WATCHDOG_SUPERVISOR_H_INCLUDED
+#define WATCHDOG_SUPERVISOR_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+
+#define WATCHDOGSUPERVISOR_MAXTHREADS MAXNUMTHREADS // maximum number of registered threads
+#define WATCHDOGSUPERVISOR_NAMELEN 24               // bytes of the thread's name saved, including '\0'
+
+typedef struct WatchdogSupervisor_Report
+{
+    char threadName[WATCHDOGSUPERVISOR_NAMELEN];
+    uint32_t overdueMs; // time elapsed since the deadline
+    uint32_t sleep;     // remaining sleep, or timeout if blocked
+    bool blocked;       // whether it was blocked on a semaphore
+    uint8_t priority;
+} WatchdogSupervisor_Report;
+
+void WatchdogSupervisor_Init(uint32_t periodMs);
+uint32_t WatchdogSupervisor_Register(uint32_t deadlineMs);
+void WatchdogSupervisor_Unregister(uint32_t handle);
+void WatchdogSupervisor_CheckIn(uint32_t handle);
+bool WatchdogSupervisor_ReportGet(WatchdogSupervisor_Report *report);
+
+#endif
@@ -0,0 +1,35 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart-init.h"
+#include <utils/uartstdio.h>
+#include "os.h"
+
+#include "wcet-probe.h"
+
+#ifdef WCET_PROBE
+
+#if !OS_CONFIG_CYCLES_ACCOUNTING
+#error "WCET_PROBE needs OS_CONFIG_CYCLES_ACCOUNTING"
+#endif
+
+void WcetProbe_Start(WcetProbe *probe)
+{
+    probe->startCycles = OS_ThreadCyclesGet(OS_ThreadSelfGet());
+}
+
+void WcetProbe_Stop(WcetProbe *probe)
+{
+    uint32_t cycles = OS_ThreadCyclesGet(OS_ThreadSelfGet()) - probe->startCycles;
+    if (cycles > probe->maxCycles)
+    {
+        probe->maxCycles = cycles;
+    }
+    probe->jobs++;
+}
+
+void WcetProbe_Print(WcetProbe *probe)
+{
+    UARTprintf("wcet,%s,%u,%u\n", probe->name, probe->maxCycles, probe->jobs);
+}
+
+#endif
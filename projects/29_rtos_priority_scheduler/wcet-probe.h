@@ -0,0 +1,67 @@
+//*****************************************************************************
+//
+// Measure the worst-case execution time (WCET) of a thread's job, that is,
+//   of the work done between two points of its loop.
+// Only the cycles spent running the thread are counted (see
+//   `OS_ThreadCyclesGet`), so preemption by other threads is excluded.
+//
+// `WcetProbe_Print` writes a line in the form:
+//
+//     wcet,<name>,<max cycles>,<jobs>
+//
+// which `tools/schedulability.c` reads from the serial log: `<name>` must
+//   match the thread's name in the thread set file.
+//
+// The probes are compiled in only when `WCET_PROBE` is defined, which needs
+//   OS_CONFIG_CYCLES_ACCOUNTING; otherwise, they expand to nothing.
+//
+// Usage:
+// ```c
+// #include "wcet-probe.h"
+//
+// WCETPROBE_DEFINE(probe, "userTaskOnPB6RisingEdgeThread");
+//
+// while (1)
+// {
+//     OS_SemaphoreWait(&GPIOPB6_Signal_RisingEdgeHit);
+//     WcetProbe_Start(&probe);
+//     DoSomething();
+//     WcetProbe_Stop(&probe);
+// }
+//
+// WcetProbe_Print(&probe); // from any thread, after UART_Init
+// ```
+//
+//*****************************************************************************
+
+#ifndef WCET_PROBE_H_INCLUDED
+#define WCET_PROBE_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct WcetProbe
+{
+    const char *name;     // name of the thread in the thread set file
+    uint32_t startCycles; // thread's cycles at WcetProbe_Start
+    uint32_t maxCycles;   // longest job measured
+    uint32_t jobs;        // number of jobs measured
+} WcetProbe;
+
+#ifdef WCET_PROBE
+#define WCETPROBE_DEFINE(probeName, threadName) \
+    static WcetProbe probeName = {.name = threadName}
+
+void WcetProbe_Start(WcetProbe *probe);
+void WcetProbe_Stop(WcetProbe *probe);
+void WcetProbe_Print(WcetProbe *probe);
+#else
+// only declared, so that no storage is used
+#define WCETPROBE_DEFINE(probeName, threadName) extern WcetProbe probeName
+
+#define WcetProbe_Start(probe)
+#define WcetProbe_Stop(probe)
+#define WcetProbe_Print(probe)
+#endif
+
+#endif
@@ -1,24 +1,23 @@
 //******************************************************************************
 //
-// A simplified heap manager that handles just fixed size blocks.
+// Heap managers for the `.sysmem` section, one after the other on the same
+//   heap, each printing its state over UART.
 //
-// Initialization must be performed before the heap can be used.
-// `Heap_Init` partitions the heap into blocks and links them all together.
-// `BLOCK_SIZE` is the number of 8-bit bytes in each block.
-// All blocks allocated and released with this memory manager will be of
-//   this fixed size.
+// First, a heap manager that handles just fixed size blocks, safe to use
+//   from ISRs, see `heap-blocks.h`. In the demo, the SysTick ISR allocates
+//   a buffer of samples every 1ms, while the main thread allocates and
+//   releases blocks in a loop.
 //
-// The variable `freePt` points to a linear linked list of free blocks.
-// Initially these free blocks are contiguous and in order, but as the manager
-//   is used, the positions and order of the free blocks can vary.
-// It will be the pointers that will link the free blocks together.
+// A 6-byte string wastes most of a block, and nothing bigger than a block
+//   can be allocated. So the same heap is then handed over to a heap manager
+//   with size classes from 8 to 256 bytes, see `heap-classes.h`, then
+//   to a TLSF heap manager, for blocks of any size, see `heap-tlsf.h`, and
+//   last to a buddy heap manager, for power-of-two buffers aligned to their
+//   size, see `heap-buddy.h`.
 //
-// To allocate a block, the manager just removes one block from the free list.
-// The `Heap_Allocate` function will fail and return a NULL pointer when the
-//   heap becomes empty.
-// The `Heap_Release` function returns a block to the free list.
-// This system does not check to verify a released block actually was
-//   previously allocated.
+// The heap managers don't depend on the microcontroller: they're fuzzed and
+//   benchmarked on the host with `tools/heap-fuzzer.c` and
+//   `tools/heap-benchmark.c`.
 //
 // The following symbols, created by the linker, are used to determine the
 //   addresses and size in memory of stack and heap:
@@ -46,8 +45,13 @@
 #include <stdbool.h>
 #include <string.h>
 #include <driverlib/debug.h>
+#include <driverlib/systick.h>
 #include "uart-init.h"
 #include <utils/uartstdio.h>
+#include "heap-blocks.h"
+#include "heap-classes.h"
+#include "heap-tlsf.h"
+#include "heap-buddy.h"
 
 #ifdef DEBUG
 void __error__(char *pcFilename, uint32_t ui32Line)
@@ -58,7 +62,7 @@ void __error__(char *pcFilename, uint32_t ui32Line)
 #endif
 
 #define NULL 0
-#define BLOCK_SIZE 80 // size of each memory block in bytes
+#define SAMPLES (HEAP_BLOCKSIZE / sizeof(uint32_t))
 
 //
 // Linker Symbols
@@ -70,13 +74,14 @@ extern uint32_t __SYSMEM_SIZE;
 static uint32_t stackStartAddress = (uint32_t)&__STACK_TOP;
 static uint32_t heapStartAddress = (uint32_t)&_sys_memory;
 static uint32_t heapSize = (uint32_t)&__SYSMEM_SIZE;
-#define heapEndAddress (heapStartAddress + heapSize)
 
-static uint32_t *freePt;
-
-void Heap_Init(void);
-void *Heap_Allocate(void);
-void Heap_Release(void *pt);
+//
+// The fn sysTickSampler allocates a new buffer of samples, and releases
+//   the previous one, on every SysTick interrupt.
+//
+static void sysTickSampler(void);
+static uint32_t *samplesPt;
+static uint32_t samplesAllocated;
 
 int main(void)
 {
@@ -84,9 +89,9 @@ int main(void)
     UARTprintf("Stack address: 0x%x\n", stackStartAddress);
     UARTprintf("Heap  address: 0x%x\n", heapStartAddress);
     UARTprintf("Heap  size:    0x%x (%d bytes)\n", heapSize, heapSize);
-    UARTprintf("Heap  blocks:  %d\n\n", (heapSize / BLOCK_SIZE));
+    UARTprintf("Heap  blocks:  %d\n\n", (heapSize / HEAP_BLOCKSIZE));
 
-    Heap_Init();
+    Heap_Init((void *)heapStartAddress, heapSize);
 
     char *strA = Heap_Allocate();
     strcpy(strA, "Hello... ");
@@ -99,41 +104,89 @@ int main(void)
 
     Heap_Release(strA);
     Heap_Release(strB);
-    while (1)
+    Heap_Release(strA);               // rejected, already free
+    Heap_Release(&stackStartAddress); // rejected, not in the heap
+
+    SysTickPeriodSet(16000);
+    SysTickIntRegister(sysTickSampler);
+    SysTickEnable();
+
+    uint32_t threadAllocated = 0;
+    for (uint32_t idx = 0; idx < 100000; idx++)
     {
+        uint32_t *blockPt = Heap_Allocate();
+        if (blockPt != NULL)
+        {
+            blockPt[0] = idx;
+            threadAllocated++;
+            Heap_Release(blockPt);
+        }
     }
-}
 
-void Heap_Init(void)
-{
-    freePt = (uint32_t *)heapStartAddress;
-
-    // Pointer arithmetic on uint32_t increments the memory address 4 bytes
-    //   each time, so the value of BLOCK_SIZE, in bytes, must be divided by 4.
-    uint32_t *iteratingPt;
-    for (iteratingPt = freePt;
-         iteratingPt < (uint32_t *)heapEndAddress;
-         iteratingPt += (BLOCK_SIZE / 4))
+    SysTickDisable();
+    SysTickIntUnregister();
+    Heap_Release(samplesPt);
+    UARTprintf("Blocks allocated by thread: %d, by ISR: %d\n\n", threadAllocated, samplesAllocated);
+    Heap_StatsPrint();
+
+    Heap_ClassesInit((void *)heapStartAddress, heapSize);
+
+    char *strC = Heap_Alloc(sizeof("Hello, "));
+    strcpy(strC, "Hello, ");
+    char *strD = Heap_Alloc(sizeof("world! ") * 20);
+    for (uint32_t idx = 0; idx < 20; idx++)
     {
-        *iteratingPt = (uint32_t)(iteratingPt + (BLOCK_SIZE / 4));
+        strcpy(&strD[idx * 7], "world! ");
     }
+    UARTprintf("strC: %s\nstrD: %s\n\n", strC, strD);
+    Heap_ClassesPrint();
 
-    *iteratingPt = NULL;
-}
+    Heap_Free(strC);
+    Heap_Free(strD);
 
-void *Heap_Allocate(void)
-{
-    uint32_t *pt = freePt;
-    if (pt != NULL)
+    Tlsf_Init((void *)heapStartAddress, heapSize);
+    UARTprintf("\nTLSF free bytes: %d\n", Tlsf_FreeBytesGet());
+
+    char *strE = Tlsf_Alloc(sizeof("Hello, world!"));
+    strcpy(strE, "Hello, world!");
+    uint32_t *samples = Tlsf_Alloc(300 * sizeof(uint32_t));
+    UARTprintf("strE: %s\nTLSF free bytes: %d\n", strE, Tlsf_FreeBytesGet());
+
+    Tlsf_Free(samples);
+    Tlsf_Free(strE);
+    UARTprintf("TLSF free bytes: %d\n", Tlsf_FreeBytesGet());
+
+    Buddy_Init((void *)heapStartAddress, heapSize);
+
+    uint8_t *frame = Buddy_Alloc(512);   // SSD1306 framebuffer
+    uint16_t *ping = Buddy_Alloc(256);   // ADC ping-pong buffers
+    uint16_t *pong = Buddy_Alloc(256);
+    uint8_t *uartDma = Buddy_Alloc(64);  // UART uDMA buffer
+    UARTprintf("\nframe: 0x%x, ping: 0x%x, pong: 0x%x, uartDma: 0x%x\n", frame, ping, pong, uartDma);
+    Buddy_Print();
+
+    Buddy_Free(ping);
+    Buddy_Free(uartDma);
+    Buddy_Print();
+    Buddy_Free(pong);
+    Buddy_Free(frame);
+
+    while (1)
     {
-        freePt = (uint32_t *)*pt;
     }
-    return pt;
 }
 
-void Heap_Release(void *pt)
+static void sysTickSampler(void)
 {
-    uint32_t *oldFreePt = freePt;
-    freePt = (uint32_t *)pt;
-    *freePt = (uint32_t)oldFreePt;
+    uint32_t *newSamplesPt = Heap_Allocate();
+    if (newSamplesPt == NULL)
+        return;
+
+    for (uint32_t idx = 0; idx < SAMPLES; idx++)
+    {
+        newSamplesPt[idx] = SysTickValueGet();
+    }
+    samplesAllocated++;
+    Heap_Release(samplesPt);
+    samplesPt = newSamplesPt;
 }
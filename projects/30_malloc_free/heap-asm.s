@@ -0,0 +1,25 @@
+        .thumb
+        .text
+        .align 2
+
+        .def  HeapAsm_LoadExclusive
+        .def  HeapAsm_StoreExclusive
+        .def  HeapAsm_ClearExclusive
+
+HeapAsm_LoadExclusive: .asmfunc ; uint32_t (uint32_t *addr)
+    LDREX   R0, [R0]           ; R0 = *addr, and tag addr for exclusive access
+    BX      LR
+   .endasmfunc
+
+HeapAsm_StoreExclusive: .asmfunc ; uint32_t (uint32_t value, uint32_t *addr)
+    STREX   R2, R0, [R1]       ; *addr = value, unless the tag was lost
+    MOV     R0, R2             ; 0 if stored, 1 if not
+    BX      LR
+   .endasmfunc
+
+HeapAsm_ClearExclusive: .asmfunc ; void (void)
+    CLREX                      ; drop the tag of the last LDREX
+    BX      LR
+   .endasmfunc
+
+   .end
@@ -0,0 +1,295 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <driverlib/debug.h>
+#include <utils/uartstdio.h>
+
+#include "heap-blocks.h"
+
+#define HEAD_INDEX_MASK 0x0000FFFF // index of the first free block, 0 if none
+#define HEAD_TAG_MASK 0xFFFF0000   // incremented on every update
+#define HEAD_TAG_ONE 0x00010000
+
+static uint8_t *heapStartPt;
+static uint32_t blockCount;
+static uint32_t freeHead;
+static uint32_t bumpIdx; // blocks taken from the heap, never allocated before
+static uint32_t allocatedMap[(HEAP_MAXBLOCKS + 31) / 32];
+
+//
+// The last site counts the blocks allocated by all the call sites that
+//   didn't find a free entry.
+// An entry is claimed by setting `line` with LDREX/STREX, and `file` is set
+//   right after: if an ISR finds an entry with its line but `file` not set
+//   yet, it doesn't match, so a call site may take two entries, but blocks
+//   are never counted against another site. `file` is compared by address,
+//   since the compiler merges the copies of `__FILE__` within a file.
+//
+typedef struct Heap_Site
+{
+    const char *file;   // file of the call, 0 until the entry is claimed
+    uint32_t line;      // line of the call, 0 while the entry is free
+    uint32_t allocated; // blocks allocated from this call site
+} Heap_Site;
+
+static Heap_Stats stats;
+static Heap_Site sites[HEAP_MAXSITES];
+
+//
+// The fn HeapAsm_LoadExclusive, HeapAsm_StoreExclusive and
+//   HeapAsm_ClearExclusive, defined in heap-asm.s, wrap LDREX, STREX and
+//   CLREX. HeapAsm_StoreExclusive returns 0 if the value was stored.
+// On the host there are no interrupts, so a store never fails.
+//
+#if defined(__TI_ARM__)
+uint32_t HeapAsm_LoadExclusive(uint32_t *addr);
+uint32_t HeapAsm_StoreExclusive(uint32_t value, uint32_t *addr);
+void HeapAsm_ClearExclusive(void);
+#else
+static inline uint32_t HeapAsm_LoadExclusive(uint32_t *addr)
+{
+    return *addr;
+}
+
+static inline uint32_t HeapAsm_StoreExclusive(uint32_t value, uint32_t *addr)
+{
+    *addr = value;
+    return 0;
+}
+
+static inline void HeapAsm_ClearExclusive(void)
+{
+}
+#endif
+
+//
+// The fn blockToIndex and indexToBlock convert between the address of a
+//   block and its index in `freeHead`, from 1; NULL maps to 0.
+//
+static inline uint32_t blockToIndex(uint32_t *pt);
+static inline uint32_t *indexToBlock(uint32_t idx);
+
+//
+// The fn bumpAllocate returns the next block never allocated, or NULL if
+//   all the blocks have been.
+//
+static uint32_t *bumpAllocate(void);
+
+//
+// The fn atomicAdd adds `delta` to `*addr` and returns the new value.
+// The fn atomicMax raises `*addr` to `value`, if it's lower.
+// Both can be interrupted by ISRs that update the same counter.
+//
+static uint32_t atomicAdd(uint32_t *addr, int32_t delta);
+static void atomicMax(uint32_t *addr, uint32_t value);
+
+//
+// The fn mapUpdate sets the bit of block `idx`, from 0, in `allocatedMap`
+//   to `isAllocated`. It returns false, and leaves the bit alone, if the bit
+//   already had that value.
+//
+static bool mapUpdate(uint32_t idx, bool isAllocated);
+
+//
+// The fn siteCount counts a block allocated from `line` of `file`.
+//
+static void siteCount(const char *file, uint32_t line);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void Heap_Init(void *heapStart, uint32_t heapSize)
+{
+    heapStartPt = heapStart;
+    blockCount = heapSize / HEAP_BLOCKSIZE; // a partial block at the end is left out
+    ASSERT(blockCount <= HEAP_MAXBLOCKS);
+    freeHead = blockToIndex(NULL);
+    bumpIdx = 0;
+
+    memset(allocatedMap, 0, sizeof(allocatedMap));
+    memset(&stats, 0, sizeof(stats));
+    memset(sites, 0, sizeof(sites));
+}
+
+void *Heap_AllocateAt(const char *file, uint32_t line)
+{
+    uint32_t head, newHead;
+    uint32_t *pt;
+    do
+    {
+        head = HeapAsm_LoadExclusive(&freeHead);
+        pt = indexToBlock(head & HEAD_INDEX_MASK);
+        if (pt == NULL)
+        {
+            HeapAsm_ClearExclusive();
+            break;
+        }
+        // if an ISR takes `pt` meanwhile, the STREX below fails
+        newHead = ((head & HEAD_TAG_MASK) + HEAD_TAG_ONE) | *pt;
+    } while (HeapAsm_StoreExclusive(newHead, &freeHead) != 0);
+
+    if (pt == NULL)
+    {
+        pt = bumpAllocate();
+    }
+    if (pt == NULL)
+    {
+        atomicAdd(&stats.failed, 1);
+        return NULL;
+    }
+
+    mapUpdate(blockToIndex(pt) - 1, true);
+    atomicMax(&stats.peakUsed, atomicAdd(&stats.used, 1));
+    siteCount(file, line);
+    return pt;
+}
+
+void Heap_Release(void *pt)
+{
+    if (pt == NULL)
+        return;
+
+    uintptr_t offset = (uint8_t *)pt - heapStartPt; // wraps if below the heap
+    if ((offset >= blockCount * HEAP_BLOCKSIZE) || ((offset % HEAP_BLOCKSIZE) != 0))
+    {
+        atomicAdd(&stats.foreignReleases, 1);
+        return;
+    }
+    if (!mapUpdate(offset / HEAP_BLOCKSIZE, false))
+    {
+        atomicAdd(&stats.doubleReleases, 1);
+        return;
+    }
+    atomicAdd(&stats.used, -1);
+
+    uint32_t head, newHead;
+    do
+    {
+        head = HeapAsm_LoadExclusive(&freeHead);
+        *(uint32_t *)pt = head & HEAD_INDEX_MASK;
+        newHead = ((head & HEAD_TAG_MASK) + HEAD_TAG_ONE) | blockToIndex(pt);
+    } while (HeapAsm_StoreExclusive(newHead, &freeHead) != 0);
+}
+
+void Heap_StatsGet(Heap_Stats *statsPt)
+{
+    *statsPt = stats;
+}
+
+void Heap_StatsPrint(void)
+{
+    UARTprintf("Heap blocks used: %d, peak: %d, failed: %d\n", stats.used, stats.peakUsed, stats.failed);
+    UARTprintf("Releases rejected: %d double, %d foreign\n", stats.doubleReleases, stats.foreignReleases);
+    for (uint32_t idx = 0; idx < HEAP_MAXSITES; idx++)
+    {
+        if (sites[idx].allocated == 0)
+            continue;
+
+        if (idx == HEAP_MAXSITES - 1)
+            UARTprintf("  other call sites: %d blocks\n", sites[idx].allocated);
+        else
+            UARTprintf("  %s:%d: %d blocks\n", sites[idx].file, sites[idx].line, sites[idx].allocated);
+    }
+    UARTprintf("\n");
+}
+
+static inline uint32_t blockToIndex(uint32_t *pt)
+{
+    if (pt == NULL)
+        return 0;
+    return (((uint8_t *)pt - heapStartPt) / HEAP_BLOCKSIZE) + 1;
+}
+
+static inline uint32_t *indexToBlock(uint32_t idx)
+{
+    if (idx == 0)
+        return NULL;
+    return (uint32_t *)(heapStartPt + ((idx - 1) * HEAP_BLOCKSIZE));
+}
+
+static uint32_t *bumpAllocate(void)
+{
+    uint32_t idx;
+    do
+    {
+        idx = HeapAsm_LoadExclusive(&bumpIdx);
+        if (idx == blockCount)
+        {
+            HeapAsm_ClearExclusive();
+            return NULL;
+        }
+    } while (HeapAsm_StoreExclusive(idx + 1, &bumpIdx) != 0);
+    return indexToBlock(idx + 1);
+}
+
+static uint32_t atomicAdd(uint32_t *addr, int32_t delta)
+{
+    uint32_t value;
+    do
+    {
+        value = HeapAsm_LoadExclusive(addr) + delta;
+    } while (HeapAsm_StoreExclusive(value, addr) != 0);
+    return value;
+}
+
+static void atomicMax(uint32_t *addr, uint32_t value)
+{
+    do
+    {
+        if (HeapAsm_LoadExclusive(addr) >= value)
+        {
+            HeapAsm_ClearExclusive();
+            return;
+        }
+    } while (HeapAsm_StoreExclusive(value, addr) != 0);
+}
+
+static bool mapUpdate(uint32_t idx, bool isAllocated)
+{
+    uint32_t *wordPt = &allocatedMap[idx / 32];
+    uint32_t mask = 1u << (idx % 32);
+    uint32_t word;
+    do
+    {
+        word = HeapAsm_LoadExclusive(wordPt);
+        if (((word & mask) != 0) == isAllocated)
+        {
+            HeapAsm_ClearExclusive();
+            return false;
+        }
+    } while (HeapAsm_StoreExclusive(word ^ mask, wordPt) != 0);
+    return true;
+}
+
+static void siteCount(const char *file, uint32_t line)
+{
+    for (uint32_t idx = 0; idx < HEAP_MAXSITES - 1; idx++)
+    {
+        Heap_Site *site = &sites[idx];
+        uint32_t siteLine = site->line;
+        if (siteLine == 0)
+        {
+            // claim the entry, unless an ISR has just claimed it
+            siteLine = HeapAsm_LoadExclusive(&site->line);
+            if ((siteLine == 0) && (HeapAsm_StoreExclusive(line, &site->line) == 0))
+            {
+                site->file = file;
+                siteLine = line;
+            }
+            else
+            {
+                HeapAsm_ClearExclusive();
+                siteLine = site->line;
+            }
+        }
+        if ((siteLine == line) && (site->file == file))
+        {
+            atomicAdd(&site->allocated, 1);
+            return;
+        }
+    }
+    atomicAdd(&sites[HEAP_MAXSITES - 1].allocated, 1);
+}
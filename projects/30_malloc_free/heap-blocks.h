@@ -0,0 +1,89 @@
+//*****************************************************************************
+//
+// A simplified heap manager that handles just fixed size blocks.
+//
+// Initialization must be performed before the heap can be used.
+// `Heap_Init` partitions the heap into blocks, but doesn't touch them: it
+//   takes the same time whatever the size of the heap.
+// `HEAP_BLOCKSIZE` is the number of 8-bit bytes in each block.
+// All blocks allocated and released with this memory manager will be of
+//   this fixed size.
+//
+// The variable `freeHead` points to a linear linked list of free blocks,
+//   those that were released. The blocks never allocated aren't in the list:
+//   `bumpIdx` counts them off from the start of the heap instead.
+// Each free block holds the index of the next one, so that the free blocks
+//   are linked together.
+//
+// To allocate a block, the manager just removes one block from the free list,
+//   or, if the list is empty, takes the next block never allocated.
+// The `Heap_Allocate` function will fail and return a NULL pointer when the
+//   heap becomes empty.
+// The `Heap_Release` function returns a block to the free list.
+// A bitmap beside the heap, `allocatedMap`, has one bit per block, set while
+//   the block is allocated. So `Heap_Release` rejects, and counts, a pointer
+//   that isn't the start of a block of the heap, or a block that is already
+//   free, in constant time.
+// `Heap_Allocate` is a macro that records the file and the line it's called
+//   from, so that the blocks allocated are also counted per call site;
+//   `Heap_StatsPrint` prints the counters over UART.
+//
+// Both functions can be called from threads and ISRs at the same time,
+//   without masking interrupts: the head of the free list is read with LDREX
+//   and written with STREX, see `heap-asm.s`, and the update is retried if
+//   an interrupt took place in between, since exception entry clears the
+//   exclusive monitor.
+// The head, `freeHead`, holds the index of the first free block in the low
+//   half-word, and a tag in the high half-word that is incremented by every
+//   update. So a head that was read before a block was allocated and released
+//   again never matches the new one (the ABA problem), even if the update
+//   were ported to a plain compare-and-swap.
+//
+// The code doesn't depend on the microcontroller: on the host, where there
+//   are no interrupts, plain loads and stores replace LDREX and STREX, so
+//   that it can be fuzzed and benchmarked with the tools in `tools/`.
+//
+// Usage:
+// ```c
+// #include "heap-blocks.h"
+//
+// Heap_Init((void *)heapStartAddress, heapSize);
+//
+// char *str = Heap_Allocate(); // HEAP_BLOCKSIZE bytes
+// Heap_Release(str);
+//
+// Heap_Stats stats;
+// Heap_StatsGet(&stats);
+// Heap_StatsPrint(); // over UART
+// ```
+//
+//*****************************************************************************
+
+#ifndef HEAP_BLOCKS_H_INCLUDED
+#define HEAP_BLOCKS_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HEAP_BLOCKSIZE 80                       // size of each memory block in bytes
+#define HEAP_MAXBLOCKS (32768 / HEAP_BLOCKSIZE) // enough blocks for the whole SRAM
+#define HEAP_MAXSITES 8                         // call sites counted one by one
+
+typedef struct Heap_Stats
+{
+    uint32_t used;            // blocks currently allocated
+    uint32_t peakUsed;        // highest value of `used`
+    uint32_t failed;          // allocations that found the heap empty
+    uint32_t doubleReleases;  // releases of a block already free
+    uint32_t foreignReleases; // releases of a pointer that isn't a block
+} Heap_Stats;
+
+#define Heap_Allocate() Heap_AllocateAt(__FILE__, __LINE__)
+
+void Heap_Init(void *heapStart, uint32_t heapSize);
+void *Heap_AllocateAt(const char *file, uint32_t line);
+void Heap_Release(void *pt);
+void Heap_StatsGet(Heap_Stats *stats);
+void Heap_StatsPrint(void);
+
+#endif
@@ -0,0 +1,225 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <driverlib/debug.h>
+#include <utils/uartstdio.h>
+
+#include "heap-buddy.h"
+
+#define NULL 0
+#define MIN_BLOCK_SIZE (1u << BUDDY_MIN_LOG2)
+
+//
+// Every block of the heap has an entry in `blockOrders`, at the index of
+//   its first 2^BUDDY_MIN_LOG2 bytes: the log2 of its size, ORed with
+//   BLOCK_FREE while it's free. The other entries are BLOCK_NONE.
+//
+#define BLOCK_NONE 0
+#define BLOCK_FREE 0x80
+#define ORDER_MASK 0x7F
+
+//
+// While a block is free, it holds the links of its free list.
+//
+typedef struct FreeBlock
+{
+    struct FreeBlock *next;
+    struct FreeBlock *prev;
+} FreeBlock;
+
+static uintptr_t heapStart;
+static uintptr_t heapEnd;
+static uint8_t blockOrders[BUDDY_MAXHEAP >> BUDDY_MIN_LOG2];
+static FreeBlock *freeLists[BUDDY_NUMORDERS];
+static uint32_t failed;
+
+//
+// The fn orderGet and orderSet read and write the entry of the block
+//   at `addr` in `blockOrders`.
+//
+static inline uint8_t orderGet(uintptr_t addr);
+static inline void orderSet(uintptr_t addr, uint8_t order);
+
+static void freeListPush(uintptr_t addr, uint32_t log2Size);
+static uintptr_t freeListPop(uint32_t log2Size);
+static void freeListRemove(uintptr_t addr, uint32_t log2Size);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void Buddy_Init(void *start, uint32_t size)
+{
+    ASSERT(size <= BUDDY_MAXHEAP);
+
+    heapStart = ((uintptr_t)start + MIN_BLOCK_SIZE - 1) & ~(uintptr_t)(MIN_BLOCK_SIZE - 1);
+    heapEnd = ((uintptr_t)start + size) & ~(uintptr_t)(MIN_BLOCK_SIZE - 1);
+    for (uint32_t idx = 0; idx < sizeof(blockOrders); idx++)
+    {
+        blockOrders[idx] = BLOCK_NONE;
+    }
+    for (uint32_t idx = 0; idx < BUDDY_NUMORDERS; idx++)
+    {
+        freeLists[idx] = NULL;
+    }
+    failed = 0;
+
+    // cover the heap with the biggest blocks aligned to their size
+    uintptr_t addr = heapStart;
+    while (addr < heapEnd)
+    {
+        uint32_t log2Size = BUDDY_MAX_LOG2;
+        while ((addr & ((1u << log2Size) - 1)) || (addr + (1u << log2Size) > heapEnd))
+        {
+            log2Size--;
+        }
+        freeListPush(addr, log2Size);
+        addr += 1u << log2Size;
+    }
+}
+
+void *Buddy_Alloc(uint32_t size)
+{
+    uint32_t log2Size = BUDDY_MIN_LOG2;
+    while ((log2Size <= BUDDY_MAX_LOG2) && ((1u << log2Size) < size))
+    {
+        log2Size++;
+    }
+
+    // the smallest free block big enough
+    uint32_t blockLog2Size = log2Size;
+    while ((blockLog2Size <= BUDDY_MAX_LOG2) && (freeLists[blockLog2Size - BUDDY_MIN_LOG2] == NULL))
+    {
+        blockLog2Size++;
+    }
+    if ((size == 0) || (blockLog2Size > BUDDY_MAX_LOG2))
+    {
+        failed++;
+        return NULL;
+    }
+
+    // split it, keeping the lower half, until it has the size requested
+    uintptr_t addr = freeListPop(blockLog2Size);
+    while (blockLog2Size > log2Size)
+    {
+        blockLog2Size--;
+        freeListPush(addr + (1u << blockLog2Size), blockLog2Size);
+    }
+    orderSet(addr, log2Size);
+    return (void *)addr;
+}
+
+void Buddy_Free(void *pt)
+{
+    if (pt == NULL)
+        return;
+
+    uintptr_t addr = (uintptr_t)pt;
+    ASSERT((addr >= heapStart) && (addr < heapEnd));
+    uint8_t order = orderGet(addr);
+    ASSERT((order != BLOCK_NONE) && !(order & BLOCK_FREE));
+
+    // merge with the buddy while it's free and of the same size
+    uint32_t log2Size = order;
+    while (log2Size < BUDDY_MAX_LOG2)
+    {
+        uintptr_t buddy = addr ^ (1u << log2Size);
+        if ((buddy < heapStart) || (buddy >= heapEnd) || (orderGet(buddy) != (BLOCK_FREE | log2Size)))
+        {
+            break;
+        }
+        freeListRemove(buddy, log2Size);
+        orderSet(addr, BLOCK_NONE);
+        orderSet(buddy, BLOCK_NONE);
+        addr = (buddy < addr) ? buddy : addr;
+        log2Size++;
+    }
+    freeListPush(addr, log2Size);
+}
+
+void Buddy_StatsGet(Buddy_Stats *stats)
+{
+    stats->freeBytes = 0;
+    stats->largestFree = 0;
+    for (uint32_t idx = 0; idx < BUDDY_NUMORDERS; idx++)
+    {
+        uint32_t blocks = 0;
+        for (FreeBlock *block = freeLists[idx]; block != NULL; block = block->next)
+        {
+            blocks++;
+        }
+        stats->freeBlocks[idx] = blocks;
+        stats->freeBytes += blocks << (idx + BUDDY_MIN_LOG2);
+        if (blocks > 0)
+        {
+            stats->largestFree = 1u << (idx + BUDDY_MIN_LOG2);
+        }
+    }
+    stats->fragmentation = stats->freeBytes
+                               ? 100 - ((100 * stats->largestFree) / stats->freeBytes)
+                               : 0;
+    stats->failed = failed;
+}
+
+void Buddy_Print(void)
+{
+    Buddy_Stats stats;
+    Buddy_StatsGet(&stats);
+    UARTprintf(" size   free\n");
+    for (uint32_t idx = 0; idx < BUDDY_NUMORDERS; idx++)
+    {
+        UARTprintf("%5u %6u\n", 1u << (idx + BUDDY_MIN_LOG2), stats.freeBlocks[idx]);
+    }
+    UARTprintf("free: %u bytes, largest: %u bytes, fragmentation: %u%%, failed: %u\n",
+               stats.freeBytes, stats.largestFree, stats.fragmentation, stats.failed);
+}
+
+static inline uint8_t orderGet(uintptr_t addr)
+{
+    return blockOrders[(addr - heapStart) >> BUDDY_MIN_LOG2];
+}
+
+static inline void orderSet(uintptr_t addr, uint8_t order)
+{
+    blockOrders[(addr - heapStart) >> BUDDY_MIN_LOG2] = order;
+}
+
+static void freeListPush(uintptr_t addr, uint32_t log2Size)
+{
+    FreeBlock **head = &freeLists[log2Size - BUDDY_MIN_LOG2];
+    FreeBlock *block = (FreeBlock *)addr;
+    block->next = *head;
+    block->prev = NULL;
+    if (*head != NULL)
+    {
+        (*head)->prev = block;
+    }
+    *head = block;
+    orderSet(addr, BLOCK_FREE | log2Size);
+}
+
+static uintptr_t freeListPop(uint32_t log2Size)
+{
+    uintptr_t addr = (uintptr_t)freeLists[log2Size - BUDDY_MIN_LOG2];
+    freeListRemove(addr, log2Size);
+    return addr;
+}
+
+static void freeListRemove(uintptr_t addr, uint32_t log2Size)
+{
+    FreeBlock *block = (FreeBlock *)addr;
+    if (block->prev != NULL)
+    {
+        block->prev->next = block->next;
+    }
+    else
+    {
+        freeLists[log2Size - BUDDY_MIN_LOG2] = block->next;
+    }
+    if (block->next != NULL)
+    {
+        block->next->prev = block->prev;
+    }
+    orderSet(addr, BLOCK_NONE);
+}
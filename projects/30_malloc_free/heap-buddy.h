@@ -0,0 +1,66 @@
+//*****************************************************************************
+//
+// A buddy heap manager, for power-of-two buffers aligned to their own size,
+//   such as display framebuffers, ADC ping-pong buffers and uDMA buffers.
+//
+// The heap is covered with the biggest blocks that are aligned to their
+//   size, up to 2^BUDDY_MAX_LOG2 bytes. A request is rounded up to a power
+//   of two, 2^k, and served by the smallest free block big enough: the block
+//   is split in halves, its buddies, until it's 2^k bytes, and the halves
+//   not used go to the free list of their size.
+// When a block is released, it's merged with its buddy, at the address
+//   given by flipping bit k, as long as the buddy is free too.
+// So allocating and releasing take at most one step per power of two.
+//
+// There's no header in front of the blocks, which would break their
+//   alignment: the size of each block is kept in a table beside the heap,
+//   with one byte per 2^BUDDY_MIN_LOG2 bytes.
+//
+// `Buddy_StatsGet` tells how fragmented the free memory is: the
+//   fragmentation is the share of free bytes that are not in the largest
+//   free block, so 0% when all free bytes could be served at once. Even the
+//   empty heap is fragmented, unless it's a single block of the biggest size.
+//
+// Usage:
+// ```c
+// #include "heap-buddy.h"
+//
+// Buddy_Init((void *)heapStartAddress, heapSize);
+//
+// uint8_t *frame = Buddy_Alloc(512); // aligned to 512 bytes
+// Buddy_Free(frame);
+//
+// Buddy_Stats stats;
+// Buddy_StatsGet(&stats);
+// Buddy_Print(); // over UART
+// ```
+//
+//*****************************************************************************
+
+#ifndef HEAP_BUDDY_H_INCLUDED
+#define HEAP_BUDDY_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BUDDY_MIN_LOG2 5       // smallest block: 32 bytes
+#define BUDDY_MAX_LOG2 12      // biggest block: 4KB
+#define BUDDY_MAXHEAP 32768    // bytes in the heap at most, the whole SRAM
+#define BUDDY_NUMORDERS (BUDDY_MAX_LOG2 - BUDDY_MIN_LOG2 + 1)
+
+typedef struct Buddy_Stats
+{
+    uint32_t freeBytes;                   // bytes in all free blocks
+    uint32_t largestFree;                 // bytes in the largest free block
+    uint32_t fragmentation;               // % of `freeBytes` not in `largestFree`
+    uint32_t freeBlocks[BUDDY_NUMORDERS]; // free blocks of each size, from the smallest
+    uint32_t failed;                      // allocations that found no block
+} Buddy_Stats;
+
+void Buddy_Init(void *heapStart, uint32_t heapSize);
+void *Buddy_Alloc(uint32_t size);
+void Buddy_Free(void *pt);
+void Buddy_StatsGet(Buddy_Stats *stats);
+void Buddy_Print(void);
+
+#endif
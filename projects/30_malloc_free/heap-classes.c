@@ -0,0 +1,138 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <driverlib/debug.h>
+#include <utils/uartstdio.h>
+
+#include "heap-classes.h"
+
+#define NULL 0
+
+typedef struct SizeClass
+{
+    uint8_t *start;   // first block of the class' region
+    uint8_t *end;     // one past the last block
+    void **freePt;    // linear linked list of free blocks
+    Heap_ClassStats stats;
+} SizeClass;
+
+static SizeClass classes[HEAP_NUMCLASSES];
+static const uint8_t classShares[HEAP_NUMCLASSES] = HEAP_CLASS_SHARES;
+
+//
+// The fn classFind returns the index of the smallest class whose blocks
+//   fit `size` bytes, or HEAP_NUMCLASSES if none does.
+//
+static uint32_t classFind(uint32_t size);
+
+//
+// The fn classOf returns the index of the class whose region contains `pt`,
+//   or HEAP_NUMCLASSES if `pt` doesn't belong to the heap.
+//
+static uint32_t classOf(void *pt);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void Heap_ClassesInit(void *heapStart, uint32_t heapSize)
+{
+    uint8_t *regionPt = heapStart;
+    for (uint32_t idx = 0; idx < HEAP_NUMCLASSES; idx++)
+    {
+        SizeClass *sizeClass = &classes[idx];
+        uint32_t blockSize = HEAP_MINBLOCKSIZE << idx;
+        uint32_t capacity = ((heapSize / 100) * classShares[idx]) / blockSize;
+
+        sizeClass->start = regionPt;
+        sizeClass->end = regionPt + (capacity * blockSize);
+        sizeClass->freePt = NULL;
+        sizeClass->stats = (Heap_ClassStats){.blockSize = blockSize, .capacity = capacity};
+
+        // link the blocks from the last one, so that the list is in order
+        for (uint8_t *blockPt = sizeClass->end; blockPt > sizeClass->start;)
+        {
+            blockPt -= blockSize;
+            *(void **)blockPt = sizeClass->freePt;
+            sizeClass->freePt = (void **)blockPt;
+        }
+        regionPt = sizeClass->end;
+    }
+}
+
+void *Heap_Alloc(uint32_t size)
+{
+    uint32_t classIdx = classFind(size);
+    if (classIdx == HEAP_NUMCLASSES)
+    {
+        return NULL;
+    }
+
+    SizeClass *sizeClass = &classes[classIdx];
+    void **pt = sizeClass->freePt;
+    if (pt == NULL)
+    {
+        sizeClass->stats.failed++;
+        return NULL;
+    }
+    sizeClass->freePt = *pt;
+    sizeClass->stats.used++;
+    if (sizeClass->stats.used > sizeClass->stats.peakUsed)
+    {
+        sizeClass->stats.peakUsed = sizeClass->stats.used;
+    }
+    return pt;
+}
+
+void Heap_Free(void *pt)
+{
+    if (pt == NULL)
+        return;
+
+    uint32_t classIdx = classOf(pt);
+    ASSERT(classIdx < HEAP_NUMCLASSES);
+    SizeClass *sizeClass = &classes[classIdx];
+    *(void **)pt = sizeClass->freePt;
+    sizeClass->freePt = pt;
+    sizeClass->stats.used--;
+}
+
+void Heap_ClassStatsGet(uint32_t classIdx, Heap_ClassStats *stats)
+{
+    *stats = classes[classIdx].stats;
+}
+
+void Heap_ClassesPrint(void)
+{
+    UARTprintf("class   blocks  used  peak failed\n");
+    for (uint32_t idx = 0; idx < HEAP_NUMCLASSES; idx++)
+    {
+        Heap_ClassStats *stats = &classes[idx].stats;
+        UARTprintf("%5u %8u %5u %5u %6u\n",
+                   stats->blockSize, stats->capacity, stats->used, stats->peakUsed, stats->failed);
+    }
+}
+
+static uint32_t classFind(uint32_t size)
+{
+    uint32_t classIdx = 0;
+    uint32_t blockSize = HEAP_MINBLOCKSIZE;
+    while ((classIdx < HEAP_NUMCLASSES) && (blockSize < size))
+    {
+        classIdx++;
+        blockSize <<= 1;
+    }
+    return classIdx;
+}
+
+static uint32_t classOf(void *pt)
+{
+    uint32_t classIdx = 0;
+    while ((classIdx < HEAP_NUMCLASSES) &&
+           !(((uint8_t *)pt >= classes[classIdx].start) && ((uint8_t *)pt < classes[classIdx].end)))
+    {
+        classIdx++;
+    }
+    return classIdx;
+}
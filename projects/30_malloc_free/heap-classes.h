@@ -0,0 +1,64 @@
+//*****************************************************************************
+//
+// A segregated-fit heap manager, with power-of-two size classes.
+//
+// The heap is split into one region per size class, from 8 to 256 bytes,
+//   and each region into blocks of its class' size. The share of the heap
+//   given to each class is set in `HEAP_CLASS_SHARES`.
+// Each class has its own free list, linked through the free blocks, just
+//   like the fixed-size heap of `heap-blocks.h`; so allocating and
+//   releasing a block only take a few instructions, plus a search among
+//   the 6 classes.
+//
+// `Heap_Alloc` picks the smallest class that fits `size`, and fails with
+//   a NULL pointer when that class is empty: it doesn't fall back to a
+//   bigger class, so that small allocations can't starve the big ones.
+// `Heap_Free` finds the class from the address of the block, so there's
+//   no header in front of the blocks.
+//
+// Usage:
+// ```c
+// #include "heap-classes.h"
+//
+// Heap_ClassesInit((void *)heapStartAddress, heapSize);
+//
+// char *str = Heap_Alloc(7); // from the 8-byte class
+// Heap_Free(str);
+//
+// Heap_ClassStats stats;
+// Heap_ClassStatsGet(0, &stats); // stats.blockSize == 8
+// Heap_ClassesPrint();           // all classes, over UART
+// ```
+//
+//*****************************************************************************
+
+#ifndef HEAP_CLASSES_H_INCLUDED
+#define HEAP_CLASSES_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HEAP_MINBLOCKSIZE 8 // size of the smallest class in bytes
+#define HEAP_NUMCLASSES 6   // 8, 16, 32, 64, 128, 256 bytes
+
+//
+// Percentage of the heap given to each class, from the smallest.
+//
+#define HEAP_CLASS_SHARES {10, 15, 20, 20, 20, 15}
+
+typedef struct Heap_ClassStats
+{
+    uint32_t blockSize; // bytes in each block of the class
+    uint32_t capacity;  // number of blocks in the class
+    uint32_t used;      // blocks currently allocated
+    uint32_t peakUsed;  // highest value of `used`
+    uint32_t failed;    // allocations that found the class empty
+} Heap_ClassStats;
+
+void Heap_ClassesInit(void *heapStart, uint32_t heapSize);
+void *Heap_Alloc(uint32_t size);
+void Heap_Free(void *pt);
+void Heap_ClassStatsGet(uint32_t classIdx, Heap_ClassStats *stats);
+void Heap_ClassesPrint(void);
+
+#endif
@@ -0,0 +1,322 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "heap-tlsf.h"
+
+#define SL_COUNT (1u << TLSF_SL_LOG2)
+#define ALIGN_SIZE (1u << TLSF_ALIGN_LOG2)
+#define FL_SHIFT (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define FL_COUNT (TLSF_FL_MAX - FL_SHIFT + 1)
+#define SMALL_BLOCK_SIZE (1u << FL_SHIFT) // below, the first level is linear
+
+//
+// Count leading zeros: a single CLZ instruction on the Cortex-M4.
+//
+#if defined(__TI_ARM__)
+#define CLZ(x) _norm(x)
+#else
+#define CLZ(x) __builtin_clz(x)
+#endif
+
+//
+// Every block starts with `prevPhys` and `size`; the payload follows.
+// While the block is free, the payload holds the links of its free list.
+// `size` is the size of the payload, a multiple of ALIGN_SIZE, so that its
+//   bit 0 can tell whether the block is free.
+//
+typedef struct Block
+{
+    struct Block *prevPhys; // block right before in memory, NULL for the first
+    uint32_t size;          // payload bytes | BLOCK_FREE
+    struct Block *nextFree; // next block in the same free list
+    struct Block *prevFree; // previous block in the same free list
+} Block;
+
+#define BLOCK_FREE 1u
+#define BLOCK_OVERHEAD offsetof(Block, nextFree)
+#define BLOCK_MIN_SIZE (sizeof(Block) - BLOCK_OVERHEAD) // room for the free links
+#define BLOCK_MAX_SIZE (1u << TLSF_FL_MAX)
+
+static uint32_t flBitmap;           // first-level lists not empty
+static uint32_t slBitmap[FL_COUNT]; // second-level lists not empty
+static Block *freeLists[FL_COUNT][SL_COUNT];
+static uint32_t freeBytes;
+
+static inline uint32_t blockSize(Block *block);
+static inline bool blockIsFree(Block *block);
+static inline Block *blockNext(Block *block);
+static inline void *blockToPayload(Block *block);
+static inline Block *payloadToBlock(void *pt);
+
+//
+// The fn msbIndex and lsbIndex return the index of the most and least
+//   significant bits set in `word`, which mustn't be 0.
+//
+static inline uint32_t msbIndex(uint32_t word);
+static inline uint32_t lsbIndex(uint32_t word);
+
+//
+// The fn mappingInsert returns the list where a free block of `size` goes.
+// The fn mappingSearch returns the first list whose blocks are all at least
+//   `size` bytes, by rounding `size` up to the next second-level range.
+//
+static void mappingInsert(uint32_t size, uint32_t *fl, uint32_t *sl);
+static void mappingSearch(uint32_t size, uint32_t *fl, uint32_t *sl);
+
+//
+// The fn freeListFind returns a free block from the list (fl, sl), or from
+//   the first non-empty list after it, and updates (fl, sl) accordingly.
+//   It returns NULL if there's no such block.
+//
+static Block *freeListFind(uint32_t *fl, uint32_t *sl);
+static void freeListInsert(Block *block);
+static void freeListRemove(Block *block);
+
+//
+// The fn blockSplit trims `block` to `size`, if the remainder can hold a
+//   block of its own, and returns the remainder to the free lists.
+// The fn blockMerge merges `block`, which is free but in no list, with its
+//   free neighbours, and returns the resulting block.
+//
+static void blockSplit(Block *block, uint32_t size);
+static Block *blockMerge(Block *block);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void Tlsf_Init(void *heapStart, uint32_t heapSize)
+{
+    flBitmap = 0;
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++)
+    {
+        slBitmap[fl] = 0;
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++)
+        {
+            freeLists[fl][sl] = NULL;
+        }
+    }
+
+    // one free block over the whole heap, followed by an empty block
+    //   that is never free, so that the last block has a next one too
+    uintptr_t start = ((uintptr_t)heapStart + ALIGN_SIZE - 1) & ~(uintptr_t)(ALIGN_SIZE - 1);
+    uintptr_t end = ((uintptr_t)heapStart + heapSize) & ~(uintptr_t)(ALIGN_SIZE - 1);
+    uint32_t size = (uint32_t)(end - start) - (2 * BLOCK_OVERHEAD);
+    if (size > BLOCK_MAX_SIZE - ALIGN_SIZE)
+    {
+        size = BLOCK_MAX_SIZE - ALIGN_SIZE;
+    }
+
+    Block *block = (Block *)start;
+    block->prevPhys = NULL;
+    block->size = size | BLOCK_FREE;
+    Block *sentinel = blockNext(block);
+    sentinel->prevPhys = block;
+    sentinel->size = 0;
+
+    freeBytes = 0;
+    freeListInsert(block);
+}
+
+void *Tlsf_Alloc(uint32_t size)
+{
+    if ((size == 0) || (size > BLOCK_MAX_SIZE - ALIGN_SIZE))
+    {
+        return NULL;
+    }
+    size = (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+    if (size < BLOCK_MIN_SIZE)
+    {
+        size = BLOCK_MIN_SIZE;
+    }
+
+    uint32_t fl, sl;
+    mappingSearch(size, &fl, &sl);
+    Block *block = freeListFind(&fl, &sl);
+    if (block == NULL)
+    {
+        return NULL;
+    }
+    freeListRemove(block);
+    block->size &= ~BLOCK_FREE;
+    blockSplit(block, size);
+    return blockToPayload(block);
+}
+
+void Tlsf_Free(void *pt)
+{
+    if (pt == NULL)
+        return;
+
+    Block *block = payloadToBlock(pt);
+    block->size |= BLOCK_FREE;
+    freeListInsert(blockMerge(block));
+}
+
+uint32_t Tlsf_FreeBytesGet(void)
+{
+    return freeBytes;
+}
+
+static inline uint32_t blockSize(Block *block)
+{
+    return block->size & ~BLOCK_FREE;
+}
+
+static inline bool blockIsFree(Block *block)
+{
+    return (block->size & BLOCK_FREE) != 0;
+}
+
+static inline Block *blockNext(Block *block)
+{
+    return (Block *)((uint8_t *)block + BLOCK_OVERHEAD + blockSize(block));
+}
+
+static inline void *blockToPayload(Block *block)
+{
+    return (uint8_t *)block + BLOCK_OVERHEAD;
+}
+
+static inline Block *payloadToBlock(void *pt)
+{
+    return (Block *)((uint8_t *)pt - BLOCK_OVERHEAD);
+}
+
+static inline uint32_t msbIndex(uint32_t word)
+{
+    return 31 - CLZ(word);
+}
+
+static inline uint32_t lsbIndex(uint32_t word)
+{
+    return msbIndex(word & (~word + 1)); // isolate the lowest bit set
+}
+
+static void mappingInsert(uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size < SMALL_BLOCK_SIZE)
+    {
+        *fl = 0;
+        *sl = size / (SMALL_BLOCK_SIZE / SL_COUNT);
+    }
+    else
+    {
+        uint32_t msb = msbIndex(size);
+        *sl = (size >> (msb - TLSF_SL_LOG2)) ^ SL_COUNT;
+        *fl = msb - FL_SHIFT + 1;
+    }
+}
+
+static void mappingSearch(uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size >= SMALL_BLOCK_SIZE)
+    {
+        size += (1u << (msbIndex(size) - TLSF_SL_LOG2)) - 1;
+    }
+    mappingInsert(size, fl, sl);
+}
+
+static Block *freeListFind(uint32_t *fl, uint32_t *sl)
+{
+    uint32_t slMap = (*fl < FL_COUNT) ? (slBitmap[*fl] & (~0u << *sl)) : 0;
+    if (slMap == 0)
+    {
+        // no block in this range, take one from the next power of two
+        uint32_t flMap = (*fl + 1 < 32) ? (flBitmap & (~0u << (*fl + 1))) : 0;
+        if (flMap == 0)
+        {
+            return NULL;
+        }
+        *fl = lsbIndex(flMap);
+        slMap = slBitmap[*fl];
+    }
+    *sl = lsbIndex(slMap);
+    return freeLists[*fl][*sl];
+}
+
+static void freeListInsert(Block *block)
+{
+    uint32_t fl, sl;
+    mappingInsert(blockSize(block), &fl, &sl);
+    Block *head = freeLists[fl][sl];
+    block->nextFree = head;
+    block->prevFree = NULL;
+    if (head != NULL)
+    {
+        head->prevFree = block;
+    }
+    freeLists[fl][sl] = block;
+    flBitmap |= (1u << fl);
+    slBitmap[fl] |= (1u << sl);
+    freeBytes += blockSize(block);
+}
+
+static void freeListRemove(Block *block)
+{
+    uint32_t fl, sl;
+    mappingInsert(blockSize(block), &fl, &sl);
+    if (block->prevFree != NULL)
+    {
+        block->prevFree->nextFree = block->nextFree;
+    }
+    else
+    {
+        freeLists[fl][sl] = block->nextFree;
+    }
+    if (block->nextFree != NULL)
+    {
+        block->nextFree->prevFree = block->prevFree;
+    }
+
+    if (freeLists[fl][sl] == NULL)
+    {
+        slBitmap[fl] &= ~(1u << sl);
+        if (slBitmap[fl] == 0)
+        {
+            flBitmap &= ~(1u << fl);
+        }
+    }
+    freeBytes -= blockSize(block);
+}
+
+static void blockSplit(Block *block, uint32_t size)
+{
+    uint32_t oldSize = blockSize(block);
+    if (oldSize < size + sizeof(Block))
+    {
+        // the remainder couldn't hold a block
+        return;
+    }
+
+    block->size = size;
+    Block *remainder = blockNext(block);
+    remainder->prevPhys = block;
+    remainder->size = (oldSize - size - BLOCK_OVERHEAD) | BLOCK_FREE;
+    blockNext(remainder)->prevPhys = remainder;
+    freeListInsert(remainder);
+}
+
+static Block *blockMerge(Block *block)
+{
+    Block *prev = block->prevPhys;
+    if ((prev != NULL) && blockIsFree(prev))
+    {
+        freeListRemove(prev);
+        prev->size += BLOCK_OVERHEAD + blockSize(block);
+        block = prev;
+        blockNext(block)->prevPhys = block;
+    }
+
+    Block *next = blockNext(block);
+    if (blockIsFree(next))
+    {
+        freeListRemove(next);
+        block->size += BLOCK_OVERHEAD + blockSize(next);
+        blockNext(block)->prevPhys = block;
+    }
+    return block;
+}
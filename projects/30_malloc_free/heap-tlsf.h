@@ -0,0 +1,50 @@
+//*****************************************************************************
+//
+// A Two-Level Segregated Fit (TLSF) heap manager, for blocks of any size,
+//   with allocation and release in constant time.
+//
+// Free blocks are kept in lists by size: the first level splits sizes by
+//   power of two, the second level splits each power of two in 16 equal
+//   ranges. Two bitmaps tell which lists aren't empty, so that finding a
+//   list with a block big enough takes two count-leading-zeros instructions
+//   (CLZ on the Cortex-M4), never a search.
+// The block found is split, and the remainder goes back to its list.
+//   When a block is released, it's merged at once with its free neighbours,
+//   so that there are never two free blocks next to each other.
+//
+// Since the block is taken from a list whose sizes are all big enough,
+//   rather than searching for the best fit, up to 1/16 of a block can be
+//   wasted on top of the 8-byte header, which bounds the fragmentation.
+//
+// The code doesn't depend on the microcontroller, so that it can be
+//   benchmarked on the host with `tools/heap-benchmark.c`.
+//
+// Usage:
+// ```c
+// #include "heap-tlsf.h"
+//
+// Tlsf_Init((void *)heapStartAddress, heapSize);
+//
+// char *str = Tlsf_Alloc(300);
+// Tlsf_Free(str);
+// uint32_t freeBytes = Tlsf_FreeBytesGet();
+// ```
+//
+//*****************************************************************************
+
+#ifndef HEAP_TLSF_H_INCLUDED
+#define HEAP_TLSF_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TLSF_SL_LOG2 4    // 16 second-level lists per power of two
+#define TLSF_ALIGN_LOG2 3 // blocks are aligned to 8 bytes
+#define TLSF_FL_MAX 16    // blocks up to 64KB, more than the whole SRAM
+
+void Tlsf_Init(void *heapStart, uint32_t heapSize);
+void *Tlsf_Alloc(uint32_t size);
+void Tlsf_Free(void *pt);
+uint32_t Tlsf_FreeBytesGet(void);
+
+#endif
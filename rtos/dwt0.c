@@ -0,0 +1,25 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dwt0.h"
+
+// The DWT registers aren't defined in `inc/tm4c123gh6pm.h`.
+// See the ARMv7-M Architecture Reference Manual, sections C1.6 and C1.8.
+#define CORE_DEMCR_R (*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL_R (*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT_R (*((volatile uint32_t *)0xE0001004))
+
+#define CORE_DEMCR_TRCENA 0x01000000 // enable the DWT unit
+#define DWT_CTRL_CYCCNTENA 0x00000001 // enable the cycles counter
+
+void Dwt0_Init(void)
+{
+    CORE_DEMCR_R |= CORE_DEMCR_TRCENA;
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+}
+
+uint32_t Dwt0_CyclesGet(void)
+{
+    return DWT_CYCCNT_R;
+}
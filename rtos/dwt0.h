@@ -0,0 +1,28 @@
+//*****************************************************************************
+//
+// Use the Data Watchpoint and Trace unit (DWT) as a free-running 32-bit
+//   counter of clock cycles.
+// Unlike `cycles-counter.h`, it leaves SysTick to the scheduler.
+//
+// Usage:
+// ```c
+// #include "dwt0.h"
+//
+// Dwt0_Init();
+// uint32_t start = Dwt0_CyclesGet();
+// DoSomething();
+// uint32_t elapsed = Dwt0_CyclesGet() - start;
+// ```
+//
+//*****************************************************************************
+
+#ifndef DWT0_H_INCLUDED
+#define DWT0_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void Dwt0_Init(void);
+uint32_t Dwt0_CyclesGet(void);
+
+#endif
@@ -0,0 +1,611 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <inc/hw_ints.h>
+#include <driverlib/interrupt.h>
+#include <driverlib/sysctl.h>
+#include "uart-init.h"
+#include <utils/uartstdio.h>
+#include "dwt0.h"
+#include "mpu0.h"
+#include "os.h"
+#include "os-queue.h"
+#include "os-stream-buffer.h"
+
+#include "kernel-benchmark.h"
+
+#if defined(KERNEL_BENCHMARK) && !OS_CONFIG_SLEEP
+#error "the kernel benchmark needs sleep"
+#endif
+
+#if defined(KERNEL_BENCHMARK) && OS_CONFIG_SLEEP
+
+//
+// Boundaries of the `.os_text` section, where the linker gathers the
+//   kernel's code. See `blinky_ccs.cmd`.
+//
+extern uint8_t __OS_TEXT_START;
+extern uint8_t __OS_TEXT_END;
+
+// Unused peripheral interrupt, pended by software to simulate an ISR
+//   signaling a thread. The timer itself is never enabled.
+#define SOFTWARE_INT INT_TIMER1A_TM4C123
+
+#define COORDINATOR_PRIORITY 4 // lower than every thread it creates
+#define PINGPONG_PRIORITY 2
+#define WAITER_PRIORITY 1
+
+typedef struct BenchStats
+{
+    const char *key;         // machine-readable name of the operation
+    const char *description; // human-readable name of the operation
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+} BenchStats;
+
+static BenchStats switchSysTick = {.key = "switch_systick", .description = "context switch, forced by SysTick"};
+static BenchStats switchVoluntary = {.key = "switch_voluntary", .description = "context switch, OS_ThreadSuspend"};
+static BenchStats semaphoreWake = {.key = "semaphore_signal_to_wake", .description = "OS_SemaphoreSignal to waiter running"};
+static BenchStats isrWake = {.key = "isr_to_thread", .description = "interrupt pended to waiter running"};
+static BenchStats threadCreate = {.key = "thread_create", .description = "OS_ThreadCreate"};
+static BenchStats threadKill = {.key = "thread_kill", .description = "OS_ThreadKill to next thread running"};
+static BenchStats queueRoundTrip = {.key = "queue_put_get", .description = "OS_QueuePut + OS_QueueGet, 4 bytes"};
+static BenchStats streamRoundTrip = {.key = "stream_write_read_16", .description = "OS_StreamBufferWrite + Read, 16 bytes"};
+static BenchStats mpuGuard = {.key = "mpu_guard_set", .description = "Mpu0_StackGuardSet, part of every switch"};
+
+// Cycles taken by two back-to-back calls to Dwt0_CyclesGet.
+static uint32_t measurementOverhead;
+
+// Signaled by the benchmark threads when they're done, see phaseDoneWait.
+#if OS_CONFIG_SEMAPHORES
+static int32_t phaseDone = 0;
+#else
+static volatile uint32_t phaseDone = 0;
+#endif
+
+// Shared between the thread (or ISR) starting a measurement and
+//   the thread ending it.
+static volatile uint32_t startCycles;
+static volatile uint32_t lastRunningId;
+#if OS_CONFIG_SEMAPHORES
+static int32_t wakeSemaphore = 0;
+static BenchStats *volatile wakeStats;
+#endif
+
+static void coordinatorThread(void);
+static void statsPush(BenchStats *stats, uint32_t cycles);
+static void statsPrint(BenchStats *stats);
+static void calibrate(void);
+static void configPrint(void);
+
+//
+// The fn benchmarkThreadStart runs `task` in a new thread: with
+//   OS_ThreadCreate, or else on one of the workers defined below.
+// The fn benchmarkThreadExit ends the task: the thread is killed, or its
+//   worker goes back to waiting for the next task.
+//
+static void benchmarkThreadStart(void (*task)(void), uint8_t priority, const char *name);
+static void benchmarkThreadExit(void);
+
+//
+// The fn phaseDoneSignal is called by each benchmark thread when it's done,
+//   and the fn phaseDoneWait by the coordinator, once per thread.
+// Without semaphores, the coordinator polls, sleeping meanwhile.
+//
+static void phaseDoneSignal(void);
+static void phaseDoneWait(void);
+
+//
+// The fn coordinatorSleep lets the benchmark threads run. The switch to the
+//   coordinator and back isn't counted as a switch between them.
+//
+static void coordinatorSleep(uint32_t ms);
+
+static void benchmarkSwitchSysTick(void);
+static void switchSysTickThreadA(void);
+static void switchSysTickThreadB(void);
+static void switchSysTickLoop(uint32_t id);
+
+static void benchmarkSwitchVoluntary(void);
+static void switchVoluntaryThread(void);
+
+#if OS_CONFIG_SEMAPHORES
+static void benchmarkWake(BenchStats *stats, bool fromIsr);
+static void waiterThread(void);
+static void softwareIntHandler(void);
+
+static void benchmarkQueue(void);
+
+static void benchmarkStreamBuffer(void);
+
+static void isrSwitchesPrint(void);
+#endif
+
+#if OS_CONFIG_THREAD_CREATE_KILL
+static void benchmarkThreadCreateKill(void);
+static void killedThread(void);
+#endif
+
+#if OS_CONFIG_STACK_GUARD
+static void benchmarkMpuGuard(void);
+#endif
+
+#if !OS_CONFIG_THREAD_CREATE_KILL
+//
+// Without OS_ThreadCreate, the coordinator and the benchmark threads are
+//   defined at compile time. Each benchmark thread is a worker, which sleeps
+//   until the coordinator hands it a task.
+//
+typedef struct BenchWorker
+{
+    TCB *tcb;
+    void (*volatile task)(void); // handed by the coordinator, cleared when taken
+    volatile bool isBusy;        // from the task handed until it returns
+} BenchWorker;
+
+#define BENCHWORKERS_LEN 2 // the most threads a benchmark runs at once
+
+static void workerThread0(void);
+static void workerThread1(void);
+static void workerLoop(BenchWorker *worker);
+
+OS_THREAD_DEFINE(kernelBenchmarkThread, coordinatorThread, COORDINATOR_PRIORITY, STACKSIZE);
+OS_THREAD_DEFINE(kernelBenchmarkWorker0, workerThread0, COORDINATOR_PRIORITY, STACKSIZE);
+OS_THREAD_DEFINE(kernelBenchmarkWorker1, workerThread1, COORDINATOR_PRIORITY, STACKSIZE);
+
+static BenchWorker workers[BENCHWORKERS_LEN] = {
+    {.tcb = &kernelBenchmarkWorker0},
+    {.tcb = &kernelBenchmarkWorker1},
+};
+#endif
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void KernelBenchmark_Init(void)
+{
+#if OS_CONFIG_THREAD_CREATE_KILL
+    OS_Init(THREADFREQ, coordinatorThread, COORDINATOR_PRIORITY, "KernelBenchmark");
+#else
+    OS_Init(THREADFREQ, 0, 0, 0);
+#endif
+#if OS_CONFIG_SEMAPHORES
+    IntRegister(SOFTWARE_INT, softwareIntHandler);
+    IntEnable(SOFTWARE_INT);
+#endif
+}
+
+static void coordinatorThread(void)
+{
+    calibrate();
+    benchmarkSwitchSysTick();
+    benchmarkSwitchVoluntary();
+#if OS_CONFIG_SEMAPHORES
+    benchmarkWake(&semaphoreWake, false);
+    benchmarkWake(&isrWake, true);
+#endif
+#if OS_CONFIG_THREAD_CREATE_KILL
+    benchmarkThreadCreateKill();
+#endif
+#if OS_CONFIG_SEMAPHORES
+    benchmarkQueue();
+    benchmarkStreamBuffer();
+#endif
+#if OS_CONFIG_STACK_GUARD
+    benchmarkMpuGuard();
+#endif
+
+    UART_Init();
+    UARTprintf("\nKernel benchmark: clock cycles @ %u Hz, %u samples each\n\n",
+               SysCtlClockGet(), KERNELBENCHMARK_SAMPLES);
+    UARTprintf("     min      avg      max  operation\n");
+    statsPrint(&switchSysTick);
+    statsPrint(&switchVoluntary);
+    statsPrint(&semaphoreWake);
+    statsPrint(&isrWake);
+    statsPrint(&threadCreate);
+    statsPrint(&threadKill);
+    statsPrint(&queueRoundTrip);
+    statsPrint(&streamRoundTrip);
+    statsPrint(&mpuGuard);
+#if OS_CONFIG_SEMAPHORES
+    isrSwitchesPrint();
+#endif
+    configPrint();
+    UARTprintf("\n");
+
+    while (1)
+    {
+        OS_ThreadSleep(1000);
+    }
+}
+
+static void statsPush(BenchStats *stats, uint32_t cycles)
+{
+    if (stats->count == KERNELBENCHMARK_SAMPLES)
+        return;
+
+    cycles = (cycles > measurementOverhead) ? (cycles - measurementOverhead) : 0;
+    if ((stats->count == 0) || (cycles < stats->min))
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+    stats->sum += cycles;
+    stats->count++;
+}
+
+//
+// The operations of the features left out of the kernel are never sampled,
+//   and aren't printed.
+//
+static void statsPrint(BenchStats *stats)
+{
+    if (stats->count == 0)
+        return;
+
+    uint32_t avg = stats->sum / stats->count;
+    UARTprintf("%8u %8u %8u  %s\n", stats->min, avg, stats->max, stats->description);
+    UARTprintf("bench,%s,%u,%u,%u,%u\n", stats->key, stats->min, avg, stats->max, stats->count);
+}
+
+//
+// The kernel configuration the benchmarks ran with, and the resulting
+//   code size, so that the serial logs of different configurations can be
+//   compared side by side.
+//
+static void configPrint(void)
+{
+    UARTprintf("\nKernel code: %u bytes\n", (uint32_t)(&__OS_TEXT_END - &__OS_TEXT_START));
+    UARTprintf("size,kernel_text,%u\n", (uint32_t)(&__OS_TEXT_END - &__OS_TEXT_START));
+    UARTprintf("config,priority_scheduler,%u\n", OS_CONFIG_PRIORITY_SCHEDULER);
+    UARTprintf("config,semaphores,%u\n", OS_CONFIG_SEMAPHORES);
+    UARTprintf("config,sleep,%u\n", OS_CONFIG_SLEEP);
+    UARTprintf("config,thread_create_kill,%u\n", OS_CONFIG_THREAD_CREATE_KILL);
+    UARTprintf("config,stack_guard,%u\n", OS_CONFIG_STACK_GUARD);
+    UARTprintf("config,cycles_accounting,%u\n", OS_CONFIG_CYCLES_ACCOUNTING);
+    UARTprintf("config,event_tasks,%u\n", OS_CONFIG_EVENT_TASKS);
+}
+
+static void calibrate(void)
+{
+    Dwt0_Init(); // the kernel does it only with OS_CONFIG_CYCLES_ACCOUNTING
+    measurementOverhead = 0xFFFFFFFF;
+    for (uint32_t idx = 0; idx < KERNELBENCHMARK_SAMPLES; idx++)
+    {
+        uint32_t start = Dwt0_CyclesGet();
+        uint32_t elapsed = Dwt0_CyclesGet() - start;
+        if (elapsed < measurementOverhead)
+        {
+            measurementOverhead = elapsed;
+        }
+    }
+}
+
+static void benchmarkThreadStart(void (*task)(void), uint8_t priority, const char *name)
+{
+#if OS_CONFIG_THREAD_CREATE_KILL
+    OS_ERRCHECK(OS_ThreadCreate(task, priority, name));
+#else
+    (void)name;
+
+    // a worker is busy until its last task returns, right after signaling
+    //   the end of the phase
+    BenchWorker *worker = 0;
+    while (!worker)
+    {
+        for (uint32_t idx = 0; (idx < BENCHWORKERS_LEN) && !worker; idx++)
+        {
+            if (!workers[idx].isBusy)
+            {
+                worker = &workers[idx];
+            }
+        }
+        if (!worker)
+        {
+            coordinatorSleep(1);
+        }
+    }
+
+    worker->isBusy = true;
+#if OS_CONFIG_PRIORITY_SCHEDULER
+    OS_ThreadSetPriority(worker->tcb, priority);
+#else
+    (void)priority;
+#endif
+    worker->task = task;
+    while (worker->task)
+    {
+        coordinatorSleep(1);
+    }
+#endif
+}
+
+static void benchmarkThreadExit(void)
+{
+#if OS_CONFIG_THREAD_CREATE_KILL
+    OS_ThreadKill();
+#endif
+}
+
+#if !OS_CONFIG_THREAD_CREATE_KILL
+static void workerThread0(void)
+{
+    workerLoop(&workers[0]);
+}
+
+static void workerThread1(void)
+{
+    workerLoop(&workers[1]);
+}
+
+static void workerLoop(BenchWorker *worker)
+{
+    while (1)
+    {
+        void (*task)(void) = worker->task;
+        if (!task)
+        {
+            OS_ThreadSleep(1);
+            continue;
+        }
+
+        worker->task = 0;
+        task();
+#if OS_CONFIG_PRIORITY_SCHEDULER
+        // so that polling for the next task doesn't preempt the coordinator
+        OS_ThreadSetPriority(worker->tcb, COORDINATOR_PRIORITY);
+#endif
+        worker->isBusy = false;
+    }
+}
+#endif
+
+static void phaseDoneSignal(void)
+{
+#if OS_CONFIG_SEMAPHORES
+    OS_SemaphoreSignal(&phaseDone);
+#else
+    IntMasterDisable();
+    phaseDone++;
+    IntMasterEnable();
+#endif
+}
+
+static void phaseDoneWait(void)
+{
+#if OS_CONFIG_SEMAPHORES
+    OS_SemaphoreWait(&phaseDone);
+#else
+    while (phaseDone == 0)
+    {
+        coordinatorSleep(10);
+    }
+    IntMasterDisable();
+    phaseDone--;
+    IntMasterEnable();
+#endif
+}
+
+static void coordinatorSleep(uint32_t ms)
+{
+    lastRunningId = 0;
+    OS_ThreadSleep(ms);
+}
+
+//
+// Two threads with the same priority spin, each recording when it last ran.
+// The first time a thread runs after the other one, the elapsed cycles are
+//   the cost of a SysTick-triggered switch.
+//
+static void benchmarkSwitchSysTick(void)
+{
+    lastRunningId = 0;
+    benchmarkThreadStart(switchSysTickThreadA, PINGPONG_PRIORITY, "switchSysTickA");
+    benchmarkThreadStart(switchSysTickThreadB, PINGPONG_PRIORITY, "switchSysTickB");
+    phaseDoneWait();
+    phaseDoneWait();
+}
+
+static void switchSysTickThreadA(void)
+{
+    switchSysTickLoop(1);
+}
+
+static void switchSysTickThreadB(void)
+{
+    switchSysTickLoop(2);
+}
+
+static void switchSysTickLoop(uint32_t id)
+{
+    while (switchSysTick.count < KERNELBENCHMARK_SAMPLES)
+    {
+        uint32_t now = Dwt0_CyclesGet();
+        if ((lastRunningId != 0) && (lastRunningId != id))
+        {
+            statsPush(&switchSysTick, now - startCycles);
+        }
+        lastRunningId = id;
+        startCycles = Dwt0_CyclesGet();
+    }
+    phaseDoneSignal();
+    benchmarkThreadExit();
+}
+
+//
+// Two threads with the same priority keep yielding to each other.
+//
+static void benchmarkSwitchVoluntary(void)
+{
+    lastRunningId = 0;
+    benchmarkThreadStart(switchVoluntaryThread, PINGPONG_PRIORITY, "switchVoluntaryA");
+    benchmarkThreadStart(switchVoluntaryThread, PINGPONG_PRIORITY, "switchVoluntaryB");
+    phaseDoneWait();
+    phaseDoneWait();
+}
+
+static void switchVoluntaryThread(void)
+{
+    while (switchVoluntary.count < KERNELBENCHMARK_SAMPLES)
+    {
+        uint32_t now = Dwt0_CyclesGet();
+        if (lastRunningId != 0)
+        {
+            statsPush(&switchVoluntary, now - startCycles);
+        }
+        lastRunningId = 1;
+        startCycles = Dwt0_CyclesGet();
+        OS_ThreadSuspend();
+    }
+    phaseDoneSignal();
+    benchmarkThreadExit();
+}
+
+#if OS_CONFIG_SEMAPHORES
+//
+// A high priority thread waits on a semaphore, which is signaled either by
+//   the coordinator, which then suspends, or by an ISR, which pends the
+//   switch with OS_SemaphoreSignalFromISR.
+// Either way, the measurement includes the switch to the woken thread.
+//
+static void benchmarkWake(BenchStats *stats, bool fromIsr)
+{
+    wakeStats = stats;
+    benchmarkThreadStart(waiterThread, WAITER_PRIORITY, "waiter");
+    OS_ThreadSuspend(); // let the waiter block on the semaphore
+
+    for (uint32_t idx = 0; idx < KERNELBENCHMARK_SAMPLES; idx++)
+    {
+        startCycles = Dwt0_CyclesGet();
+        if (fromIsr)
+        {
+            IntPendSet(SOFTWARE_INT);
+        }
+        else
+        {
+            OS_SemaphoreSignal(&wakeSemaphore);
+            OS_ThreadSuspend();
+        }
+    }
+    phaseDoneWait();
+}
+
+static void waiterThread(void)
+{
+    while (wakeStats->count < KERNELBENCHMARK_SAMPLES)
+    {
+        OS_SemaphoreWait(&wakeSemaphore);
+        statsPush(wakeStats, Dwt0_CyclesGet() - startCycles);
+    }
+    phaseDoneSignal();
+    benchmarkThreadExit();
+}
+
+static void softwareIntHandler(void)
+{
+    OS_SemaphoreSignalFromISR(&wakeSemaphore);
+}
+
+//
+// Put and get are run back-to-back by the same thread, so neither blocks.
+//
+static void benchmarkQueue(void)
+{
+    static uint32_t storage[4];
+    static OS_Queue queue;
+    uint32_t element;
+    OS_QueueInit(&queue, storage, sizeof(element), 4);
+    for (uint32_t idx = 0; idx < KERNELBENCHMARK_SAMPLES; idx++)
+    {
+        element = idx;
+        uint32_t start = Dwt0_CyclesGet();
+        OS_QueuePut(&queue, &element);
+        OS_QueueGet(&queue, &element);
+        statsPush(&queueRoundTrip, Dwt0_CyclesGet() - start);
+    }
+}
+
+//
+// Like benchmarkQueue, but moving 16 bytes at once, to compare the cost per
+//   byte with `queue_put_get`.
+//
+static void benchmarkStreamBuffer(void)
+{
+    static uint8_t storage[32];
+    static OS_StreamBuffer stream;
+    uint8_t bytes[16] = {0};
+    OS_StreamBufferInit(&stream, storage, sizeof(storage), sizeof(bytes), OS_STREAMBUFFER_NO_DELIMITER);
+    for (uint32_t idx = 0; idx < KERNELBENCHMARK_SAMPLES; idx++)
+    {
+        uint32_t start = Dwt0_CyclesGet();
+        OS_StreamBufferWrite(&stream, bytes, sizeof(bytes));
+        OS_StreamBufferRead(&stream, bytes, sizeof(bytes));
+        statsPush(&streamRoundTrip, Dwt0_CyclesGet() - start);
+    }
+}
+
+//
+// How many OS_SemaphoreSignalFromISR calls pended a switch, and how many
+//   saved one, compared to suspending after every signal in an ISR.
+//
+static void isrSwitchesPrint(void)
+{
+    UARTprintf("\nSignals from ISRs: %u switches pended, %u saved\n",
+               OS_ISRSwitchesPendedGet(), OS_ISRSwitchesSavedGet());
+    UARTprintf("isr,switches_pended,%u\n", OS_ISRSwitchesPendedGet());
+    UARTprintf("isr,switches_saved,%u\n", OS_ISRSwitchesSavedGet());
+}
+#endif
+
+#if OS_CONFIG_THREAD_CREATE_KILL
+//
+// OS_ThreadCreate is timed by the caller. The new thread, with higher
+//   priority, is run as soon as the coordinator suspends, and immediately
+//   kills itself; the coordinator is run next.
+//
+static void benchmarkThreadCreateKill(void)
+{
+    for (uint32_t idx = 0; idx < KERNELBENCHMARK_SAMPLES; idx++)
+    {
+        uint32_t start = Dwt0_CyclesGet();
+        OS_ERRCHECK(OS_ThreadCreate(killedThread, WAITER_PRIORITY, "killed"));
+        statsPush(&threadCreate, Dwt0_CyclesGet() - start);
+
+        OS_ThreadSuspend();
+        statsPush(&threadKill, Dwt0_CyclesGet() - startCycles);
+    }
+}
+
+static void killedThread(void)
+{
+    startCycles = Dwt0_CyclesGet();
+    OS_ThreadKill();
+}
+#endif
+
+#if OS_CONFIG_STACK_GUARD
+//
+// Reprogramming the stack guard is part of every context switch, so it's
+//   included in the switch benchmarks too; this isolates its cost.
+//
+static void benchmarkMpuGuard(void)
+{
+    TCB *self = OS_ThreadSelfGet();
+    for (uint32_t idx = 0; idx < KERNELBENCHMARK_SAMPLES; idx++)
+    {
+        uint32_t start = Dwt0_CyclesGet();
+        Mpu0_StackGuardSet(self->stackBase);
+        statsPush(&mpuGuard, Dwt0_CyclesGet() - start);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+//*****************************************************************************
+//
+// Micro-benchmarks for the kernel, measured in clock cycles with the DWT
+//   cycles counter (see `dwt0.h`).
+// Each operation is sampled `KERNELBENCHMARK_SAMPLES` times, then min, average,
+//   and max are printed over UART0, both as a table and as lines in the form:
+//
+//     bench,<operation>,<min>,<avg>,<max>,<samples>
+//
+// which can be grepped from the serial log and compared across kernel changes.
+// The switches pended and saved by OS_SemaphoreSignalFromISR follow, as
+//   `isr,switches_pended,<count>` and `isr,switches_saved,<count>`.
+// The kernel configuration and code size follow, as `config,<feature>,<0|1>`
+//   and `size,kernel_text,<bytes>`.
+//
+// The benchmarks build with the configuration of each of projects 26 to 29,
+//   so that code size and switch cost can be compared across them; only
+//   OS_CONFIG_SLEEP is needed. The operations of the features left out
+//   are skipped. Without OS_CONFIG_THREAD_CREATE_KILL, the benchmark
+//   threads are defined at compile time, and wait for their task.
+//
+// The benchmarks own the whole kernel while running, so no other thread
+//   should be created or defined. They're compiled only when
+//   `KERNEL_BENCHMARK` is defined for the whole project, e.g. among the
+//   predefined symbols of CCS: the `main.c` of projects 26 to 29 then runs
+//   them instead of the user threads, with:
+// ```c
+// #include "kernel-benchmark.h"
+//
+// KernelBenchmark_Init();
+// OS_Launch();
+// ```
+//
+//*****************************************************************************
+
+#ifndef KERNEL_BENCHMARK_H_INCLUDED
+#define KERNEL_BENCHMARK_H_INCLUDED
+
+#define KERNELBENCHMARK_SAMPLES 64
+
+void KernelBenchmark_Init(void);
+
+#endif
@@ -0,0 +1,61 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mpu0.h"
+
+// MPU and fault status registers.
+// See the ARMv7-M Architecture Reference Manual, sections B3.2 and B3.5.
+#define MPU_CTRL_R (*((volatile uint32_t *)0xE000ED94))
+#define MPU_BASE_R (*((volatile uint32_t *)0xE000ED9C))
+#define MPU_ATTR_R (*((volatile uint32_t *)0xE000EDA0))
+#define FAULT_STAT_R (*((volatile uint32_t *)0xE000ED28))
+#define MM_ADDR_R (*((volatile uint32_t *)0xE000ED34))
+
+#define MPU_CTRL_PRIVDEFEN 0x00000004 // default memory map for privileged code
+#define MPU_CTRL_ENABLE 0x00000001    // enable the MPU
+#define MPU_BASE_VALID 0x00000010     // use the region number in this register
+#define MPU_ATTR_XN 0x10000000        // instruction fetches disabled
+#define MPU_ATTR_AP_NO_NO 0x00000000  // no access, privileged or not
+#define MPU_ATTR_SIZE_32B 0x00000008  // (log2(32) - 1) << 1
+#define MPU_ATTR_ENABLE 0x00000001    // enable the region
+#define FAULT_STAT_MMARV 0x00000080   // MM_ADDR_R holds a valid address
+#define FAULT_STAT_MSTKE 0x00000010   // fault on exception entry stacking
+#define FAULT_STAT_DERR 0x00000002    // data access violation
+
+#define GUARD_REGION 7 // the highest region number has precedence
+#define GUARD_SIZE 32
+
+static uint32_t guardAddress(int32_t *stackBase);
+
+void Mpu0_Init(void)
+{
+    MPU_CTRL_R = MPU_CTRL_PRIVDEFEN | MPU_CTRL_ENABLE;
+}
+
+void Mpu0_StackGuardSet(int32_t *stackBase)
+{
+    MPU_BASE_R = guardAddress(stackBase) | MPU_BASE_VALID | GUARD_REGION;
+    MPU_ATTR_R = MPU_ATTR_XN | MPU_ATTR_AP_NO_NO | MPU_ATTR_SIZE_32B | MPU_ATTR_ENABLE;
+}
+
+bool Mpu0_IsStackGuardFault(int32_t *stackBase)
+{
+    uint32_t status = FAULT_STAT_R;
+    if (status & FAULT_STAT_MSTKE)
+    {
+        // the faulting address isn't recorded for stacking errors
+        return true;
+    }
+    if ((status & FAULT_STAT_DERR) && (status & FAULT_STAT_MMARV))
+    {
+        uint32_t guard = guardAddress(stackBase);
+        uint32_t faultAddress = MM_ADDR_R;
+        return (faultAddress >= guard) && (faultAddress < guard + GUARD_SIZE);
+    }
+    return false;
+}
+
+static uint32_t guardAddress(int32_t *stackBase)
+{
+    return ((uint32_t)stackBase + GUARD_SIZE - 1) & ~(uint32_t)(GUARD_SIZE - 1);
+}
@@ -0,0 +1,37 @@
+//*****************************************************************************
+//
+// Use one MPU region as a no-access guard at the bottom of a thread's stack,
+//   so that a stack overflow faults on the first write past the limit,
+//   instead of silently corrupting the memory below.
+// The guard covers the first 32-byte aligned block within the stack, so it
+//   takes between 8 and 15 of the stack's 32-bit words.
+// MemManage faults aren't enabled, so a violation escalates to a HardFault,
+//   whose handler runs with the MPU disabled and can therefore use the
+//   guard area as stack.
+//
+// Usage:
+// ```c
+// #include "mpu0.h"
+//
+// static int32_t stack[100];
+//
+// Mpu0_Init();
+// Mpu0_StackGuardSet(stack); // on every context switch
+//
+// // in the HardFault handler
+// if (Mpu0_IsStackGuardFault(stack)) {}
+// ```
+//
+//*****************************************************************************
+
+#ifndef MPU0_H_INCLUDED
+#define MPU0_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void Mpu0_Init(void);
+void Mpu0_StackGuardSet(int32_t *stackBase);
+bool Mpu0_IsStackGuardFault(int32_t *stackBase);
+
+#endif
@@ -0,0 +1,95 @@
+        .thumb
+        .text
+        .align 2
+
+        .cdecls C, NOLIST, "os-config.h"
+
+        .ref  runPt            ; currently running thread
+        .ref  OS_Scheduler
+        .def  OSAsm_Start
+        .def  OSAsm_ThreadSwitch
+
+runPtAddr .field runPt, 32
+
+        .if OS_CONFIG_EVENT_TASKS
+        .ref  OS_EventTasks    ; dispatcher thread of the event tasks
+        .ref  OS_EventTasksPreempt
+        .def  OSAsm_EventTasksPendSV
+        .def  OSAsm_EventTasksNMI
+
+eventTasksAddr .field OS_EventTasks, 32
+preemptAddr .field OS_EventTasksPreempt, 32
+preemptReturnAddr .field OSAsm_EventTasksPreemptReturn, 32
+intCtrlAddr .field 0xE000ED04, 32 ; NVIC_INT_CTRL_R
+        .endif
+
+OSAsm_Start:   .asmfunc
+    CPSID   I                  ; Disable interrupts at processor level
+    LDR     R0, runPtAddr      ; currently running thread
+    LDR     R2, [R0]           ; R2 = value of RunPt
+    LDR     SP, [R2]           ; new thread SP; SP = RunPt->stackPointer;
+    POP     {R4-R11}           ; restore regs r4-11
+    POP     {R0-R3}            ; restore regs r0-3
+    POP     {R12}
+    POP     {LR}               ; discard LR from initial stack
+    POP     {LR}               ; start location
+    POP     {R1}               ; discard PSR
+    CPSIE   I                  ; enable interrupts at processor level
+    BX      LR                 ; start first thread
+   .endasmfunc
+
+OSAsm_ThreadSwitch:  .asmfunc  ; Save R0-R3,R12,LR,PC,PSR
+    CPSID   I                  ; prevent interrupt during switch
+    PUSH    {R4-R11}           ; save remaining regs r4-11
+    LDR     R0, runPtAddr      ; R0=pointer to RunPt, old thread
+    LDR     R1, [R0]           ; R1 = RunPt
+    STR     SP, [R1]           ; save SP into TCB
+    PUSH    {R0, LR}
+    BL      OS_Scheduler
+    POP     {R0, LR}
+    LDR     R1, [R0]           ; R1 = RunPt, new thread
+    LDR     SP, [R1]           ; new thread SP; SP = RunPt->sp;
+    POP     {R4-R11}           ; restore regs r4-11
+    CPSIE   I                  ; tasks run with interrupts enabled
+    BX      LR                 ; restore R0-R3,R12,LR,PC,PSR
+   .endasmfunc
+
+        .if OS_CONFIG_EVENT_TASKS
+OSAsm_EventTasksPendSV: .asmfunc ; lowest priority: the stack is the thread's
+    CPSID   I
+    LDR     R0, runPtAddr
+    LDR     R0, [R0]           ; R0 = RunPt, the thread returned to
+    LDR     R1, eventTasksAddr
+    CMP     R0, R1
+    BNE     pendSVReturn       ; OS_Scheduler pends PendSV again on switching to it
+    LDR     R1, preemptReturnAddr
+    ORR     R1, R1, #1         ; LR, Thumb state
+    LDR     R2, preemptAddr
+    BIC     R2, R2, #1         ; PC, without the Thumb bit
+    MOV     R3, #0x01000000    ; xPSR, Thumb state
+    SUB     SP, SP, #32        ; new frame R0-R3,R12,LR,PC,PSR on top of the preempted one
+    ADD     R0, SP, #20
+    STM     R0, {R1-R3}        ; LR, PC, PSR
+    MVN     R0, #6             ; EXC_RETURN 0xFFFFFFF9: thread mode, main stack
+    BX      R0                 ; "return" to OS_EventTasksPreempt, interrupts disabled
+pendSVReturn:
+    CPSIE   I
+    BX      LR
+   .endasmfunc
+
+OSAsm_EventTasksPreemptReturn: .asmfunc ; OS_EventTasksPreempt returns here
+    CPSID   I
+    LDR     R0, intCtrlAddr
+    MOV     R1, #0x80000000    ; NMIPENDSET: taken at once, even with interrupts disabled
+    STR     R1, [R0]
+    B       OSAsm_EventTasksPreemptReturn ; never reached
+   .endasmfunc
+
+OSAsm_EventTasksNMI: .asmfunc
+    ADD     SP, SP, #32        ; drop the NMI's frame, exposing the preempted one
+    CPSIE   I
+    BX      LR                 ; restore the preempted task's R0-R3,R12,LR,PC,PSR
+   .endasmfunc
+        .endif
+
+   .end
@@ -0,0 +1,230 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <inc/hw_ints.h>
+#include <driverlib/debug.h>
+#include <driverlib/interrupt.h>
+#include "os.h"
+
+#include "os-event-tasks.h"
+
+#if OS_CONFIG_EVENT_TASKS
+
+// Priority of the running event task when none is running.
+#define NO_TASK_PRIORITY EVENTTASKS_MAXTASKS
+
+// Event tasks indexed by priority, and the bitmap of those having events
+//   pending: bit N is set if `tasks[N]` is ready.
+static OS_EventTask *tasks[EVENTTASKS_MAXTASKS];
+static volatile uint32_t readySet = 0;
+
+// Priority of the event task currently running on the dispatcher's stack.
+static uint8_t currentPriority = NO_TASK_PRIORITY;
+
+// Signaled by OS_EventTaskPost when the dispatcher is waiting for events.
+static int32_t dispatcherWake = 0;
+static bool isDispatcherWaiting = false;
+
+// Set by an ISR that posted to a task with higher priority than the running
+//   one, until the latter is preempted. If the dispatcher isn't the thread
+//   the ISR returns to, the preemption waits until it's switched in again.
+static volatile bool isPreemptionPending = false;
+
+//
+// The dispatcher thread runs the ready event tasks, then blocks until
+//   the next post. Its stack is shared by all event tasks.
+//
+static void OS_eventTasksThread(void);
+OS_THREAD_DEFINE(OS_EventTasks, OS_eventTasksThread, EVENTTASKS_PRIORITY, EVENTTASKS_STACKSIZE);
+
+//
+// The fn OS_eventTasksSchedule runs, one event at a time, the ready tasks
+//   with priority higher than the running one, if any.
+// It's called by the dispatcher thread, and by OS_EventTaskPost for
+//   synchronous preemption of the running task.
+//
+static void OS_eventTasksSchedule(void);
+
+//
+// The fn OSAsm_EventTasksPendSV, defined in os-asm.s, is the PendSV handler:
+//   if the thread being returned to is the dispatcher, it returns to thread
+//   mode into OS_EventTasksPreempt instead, on the same stack.
+// The fn OSAsm_EventTasksNMI, defined in os-asm.s, is the NMI handler,
+//   triggered once OS_EventTasksPreempt returns: it drops its own frame,
+//   so that it returns to the task that was preempted.
+//
+extern void OSAsm_EventTasksPendSV(void);
+extern void OSAsm_EventTasksNMI(void);
+
+//
+// The fn OS_EventTasksPreempt runs the tasks that preempt the running one,
+//   in thread mode, entered with interrupts disabled. It's called by
+//   OSAsm_EventTasksPendSV only.
+//
+void OS_EventTasksPreempt(void);
+
+//
+// The fn OS_highestReadyPriority returns the index of the lowest bit set in
+//   `set`, which must not be 0, using a de Bruijn sequence.
+//
+static uint8_t OS_highestReadyPriority(uint32_t set);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void OS_EventTasksInit(void)
+{
+    IntRegister(FAULT_PENDSV, OSAsm_EventTasksPendSV);
+    IntPrioritySet(FAULT_PENDSV, 0xE0); // lowest: runs only on the way back to a thread
+    IntRegister(FAULT_NMI, OSAsm_EventTasksNMI);
+}
+
+void OS_EventTasksSwitchIn(void)
+{
+    if (isPreemptionPending)
+    {
+        IntPendSet(FAULT_PENDSV);
+    }
+}
+
+void OS_EventTaskCreate(
+    OS_EventTask *task,
+    void (*handler)(uint32_t event),
+    uint8_t priority,
+    uint32_t *queue,
+    uint8_t queueLen)
+{
+    ASSERT(priority < EVENTTASKS_MAXTASKS);
+    ASSERT(tasks[priority] == 0);
+
+    task->handler = handler;
+    task->queue = queue;
+    task->queueLen = queueLen;
+    task->head = 0;
+    task->count = 0;
+    task->priority = priority;
+    tasks[priority] = task;
+}
+
+OS_Err OS_EventTaskPost(OS_EventTask *task, uint32_t event)
+{
+    IntMasterDisable();
+    if (task->count == task->queueLen)
+    {
+        IntMasterEnable();
+        return OS_ERR_QUEUE_FULL;
+    }
+
+    uint32_t tail = task->head + task->count;
+    if (tail >= task->queueLen)
+    {
+        // wrap
+        tail -= task->queueLen;
+    }
+    task->queue[tail] = event;
+    task->count++;
+    readySet |= (1u << task->priority);
+
+    bool mustWakeDispatcher = isDispatcherWaiting;
+    isDispatcherWaiting = false;
+    IntMasterEnable();
+
+    if (mustWakeDispatcher)
+    {
+        if (OS_IsInterruptContext())
+        {
+            OS_SemaphoreSignalFromISR(&dispatcherWake);
+        }
+        else
+        {
+            OS_SemaphoreSignal(&dispatcherWake);
+        }
+    }
+    else if (task->priority < currentPriority)
+    {
+        if (!OS_IsInterruptContext())
+        {
+            if (OS_ThreadSelfGet() == &OS_EventTasks)
+            {
+                // posted by an event task to a higher priority one
+                OS_eventTasksSchedule();
+            }
+        }
+        else if (currentPriority != NO_TASK_PRIORITY)
+        {
+            // preempt the running task on the ISR's exit; between two tasks,
+            //   the dispatcher picks the new one next anyway
+            isPreemptionPending = true;
+            IntPendSet(FAULT_PENDSV);
+        }
+    }
+    return OS_ERR_NONE;
+}
+
+static void OS_eventTasksThread(void)
+{
+    while (1)
+    {
+        IntMasterDisable();
+        if (readySet == 0)
+        {
+            isDispatcherWaiting = true;
+            IntMasterEnable();
+            OS_SemaphoreWait(&dispatcherWake);
+        }
+        IntMasterEnable();
+        OS_eventTasksSchedule();
+    }
+}
+
+static void OS_eventTasksSchedule(void)
+{
+    IntMasterDisable();
+    uint8_t preemptedPriority = currentPriority;
+    while (readySet != 0)
+    {
+        uint8_t priority = OS_highestReadyPriority(readySet);
+        if (priority >= preemptedPriority)
+            break;
+
+        OS_EventTask *task = tasks[priority];
+        uint32_t event = task->queue[task->head];
+        task->head++;
+        if (task->head == task->queueLen)
+        {
+            // wrap
+            task->head = 0;
+        }
+        task->count--;
+        if (task->count == 0)
+        {
+            readySet &= ~(1u << priority);
+        }
+
+        currentPriority = priority;
+        IntMasterEnable();
+        task->handler(event);
+        IntMasterDisable();
+    }
+    currentPriority = preemptedPriority;
+    IntMasterEnable();
+}
+
+void OS_EventTasksPreempt(void)
+{
+    isPreemptionPending = false;
+    OS_eventTasksSchedule();
+}
+
+static uint8_t OS_highestReadyPriority(uint32_t set)
+{
+    static const uint8_t deBruijnPositions[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9};
+    uint32_t lowestBit = set & (~set + 1);
+    return deBruijnPositions[(lowestBit * 0x077CB531u) >> 27];
+}
+
+#endif
@@ -0,0 +1,79 @@
+//*****************************************************************************
+//
+// Run-to-completion event tasks, in the style of SST (Super Simple Tasker).
+// An event task is just a handler called once per event posted to it: it has
+//   no stack of its own and must return, without ever blocking or sleeping.
+// All event tasks run on the stack of a single kernel thread, the dispatcher,
+//   so many short event handlers cost a few bytes each instead of one
+//   `STACKSIZE` stack each. They coexist with the other threads, which
+//   preempt the dispatcher or are preempted by it according to
+//   `EVENTTASKS_PRIORITY`.
+//
+// Each event task has a unique priority, from 0 (highest) to 31 (lowest),
+//   and a caller-provided queue of pending events. The dispatcher runs the
+//   highest priority task found in the ready bitmap. When a task posts to
+//   a higher priority task, the latter is run immediately, nested on the
+//   same stack, before the post returns.
+// When an ISR posts to a task with higher priority than the running one,
+//   the latter is preempted on the ISR's exit, as in QK: PendSV, at the
+//   lowest exception priority, "returns" to thread mode into the dispatcher
+//   on top of the preempted task's frame, and once the higher priority tasks
+//   are done, an NMI resumes the preempted task where it was interrupted.
+//   See `os-asm.s`. The NMI and PendSV are reserved to the kernel.
+//
+// Usage:
+// ```c
+// #include "os-event-tasks.h"
+//
+// static OS_EventTask buttonTask;
+// static uint32_t buttonEvents[4];
+//
+// void onButton(uint32_t event) {} // run to completion
+//
+// OS_EventTaskCreate(&buttonTask, onButton, 3, buttonEvents, 4);
+// OS_ERRCHECK(OS_EventTaskPost(&buttonTask, 123)); // from a thread, a task, or an ISR
+// ```
+//
+//*****************************************************************************
+
+#ifndef OS_EVENT_TASKS_H_INCLUDED
+#define OS_EVENT_TASKS_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+
+#define EVENTTASKS_PRIORITY 1          // thread priority of the dispatcher
+#define EVENTTASKS_STACKSIZE STACKSIZE // number of 32-bit words in the shared stack
+#define EVENTTASKS_MAXTASKS 32         // number of event task priorities
+
+typedef struct OS_EventTask
+{
+    void (*handler)(uint32_t event);
+    uint32_t *queue;  // caller-provided storage for pending events
+    uint8_t queueLen; // capacity of `queue`
+    uint8_t head;     // index of the next event to be handled
+    uint8_t count;    // number of pending events
+    uint8_t priority; // 0 is highest, 31 is lowest
+} OS_EventTask;
+
+#if OS_CONFIG_EVENT_TASKS
+extern TCB OS_EventTasks; // the dispatcher thread
+
+//
+// Used by the kernel only: OS_Init calls OS_EventTasksInit, and OS_Scheduler
+//   calls OS_EventTasksSwitchIn when it switches to the dispatcher.
+//
+void OS_EventTasksInit(void);
+void OS_EventTasksSwitchIn(void);
+
+void OS_EventTaskCreate(
+    OS_EventTask *task,
+    void (*handler)(uint32_t event),
+    uint8_t priority,
+    uint32_t *queue,
+    uint8_t queueLen);
+OS_Err OS_EventTaskPost(OS_EventTask *task, uint32_t event);
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+
+#include "os-future.h"
+
+#if OS_CONFIG_SEMAPHORES
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void OS_FutureStart(OS_Future *f)
+{
+    f->done = 0;
+    f->result = OS_ERR_NONE;
+    f->value = 0;
+    f->isPending = true;
+}
+
+void OS_FutureComplete(OS_Future *f, OS_Err result, uint32_t value)
+{
+    f->result = result;
+    f->value = value;
+    f->isPending = false;
+    if (OS_IsInterruptContext())
+    {
+        // switch to the waiting thread on return only if it outranks the running one
+        OS_SemaphoreSignalFromISR(&f->done);
+    }
+    else
+    {
+        OS_SemaphoreSignal(&f->done);
+    }
+}
+
+bool OS_FutureIsDone(OS_Future *f)
+{
+    return !f->isPending;
+}
+
+OS_Err OS_Await(OS_Future *f)
+{
+    OS_SemaphoreWait(&f->done);
+    return f->result;
+}
+
+#if OS_CONFIG_SLEEP
+OS_Err OS_AwaitTimeout(OS_Future *f, uint32_t timeoutMs)
+{
+    OS_Err err = OS_SemaphoreWaitTimeout(&f->done, timeoutMs);
+    if (err != OS_ERR_NONE)
+    {
+        return err;
+    }
+    return f->result;
+}
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+//*****************************************************************************
+//
+// Futures, to wait for a transfer started by a driver without busy-waiting.
+// The driver starts the transfer, marks the future as pending with
+//   `OS_FutureStart`, and returns; its ISR completes the future with
+//   `OS_FutureComplete`, which wakes up the thread waiting in `OS_Await`.
+// While the transfer is on the bus, the waiting thread is blocked, so that
+//   the other threads can run.
+//
+// A future has one waiter at a time, and can be reused for the next
+//   transfer once completed.
+// If `OS_AwaitTimeout` times out, the transfer is still pending: the driver
+//   decides whether to abort it or to await it again.
+//
+// Usage:
+// ```c
+// #include "os-future.h"
+//
+// // driver
+// OS_Future *Driver_SendAsync(const uint8_t *data, uint32_t len)
+// {
+//     OS_FutureStart(&transfer);
+//     StartTheHardware(data, len);
+//     return &transfer;
+// }
+//
+// void Driver_IntHandler(void)
+// {
+//     OS_FutureComplete(&transfer, OS_ERR_NONE, bytesSent); // OS_ERR_IO on errors
+// }
+//
+// // thread
+// OS_Future *transfer = Driver_SendAsync(data, 16);
+// DoSomethingElse();
+// OS_Err err = OS_Await(transfer);                       // transfer->value == bytesSent
+// err = OS_AwaitTimeout(Driver_SendAsync(data, 16), 5); // OS_ERR_TIMEOUT after 5ms
+// ```
+//
+//*****************************************************************************
+
+#ifndef OS_FUTURE_H_INCLUDED
+#define OS_FUTURE_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+
+typedef struct OS_Future
+{
+    int32_t done;            // semaphore signaled on completion
+    volatile bool isPending; // whether the transfer is still in progress
+    OS_Err result;           // outcome of the transfer, set by OS_FutureComplete
+    uint32_t value;          // driver-specific result, e.g. bytes transferred
+} OS_Future;
+
+#if OS_CONFIG_SEMAPHORES
+void OS_FutureStart(OS_Future *f);
+void OS_FutureComplete(OS_Future *f, OS_Err result, uint32_t value);
+bool OS_FutureIsDone(OS_Future *f);
+OS_Err OS_Await(OS_Future *f);
+#if OS_CONFIG_SLEEP
+OS_Err OS_AwaitTimeout(OS_Future *f, uint32_t timeoutMs);
+#endif
+#endif
+
+#endif
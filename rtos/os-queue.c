@@ -0,0 +1,141 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <driverlib/interrupt.h>
+#include "os.h"
+
+#include "os-queue.h"
+
+#if OS_CONFIG_SEMAPHORES
+
+//
+// The fn OS_queueCopyIn and OS_queueCopyOut move one element in and out of
+//   the queue. The caller must have already taken a slot, respectively
+//   from `roomLeft` and `currentSize`.
+//
+static void OS_queueCopyIn(OS_Queue *q, const void *element);
+static void OS_queueCopyOut(OS_Queue *q, void *element);
+
+//
+// The fn OS_queueSignal signals a semaphore of the queue from either a
+//   thread or an ISR: from an ISR, the switch to the woken-up thread is
+//   pended on return only if it outranks the running one.
+//
+static void OS_queueSignal(int32_t *s);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void OS_QueueInit(OS_Queue *q, void *buffer, uint32_t elementSize, uint32_t capacity)
+{
+    q->buffer = buffer;
+    q->elementSize = elementSize;
+    q->capacity = capacity;
+    q->putIdx = 0;
+    q->getIdx = 0;
+    q->currentSize = 0;
+    q->roomLeft = capacity;
+}
+
+void OS_QueuePut(OS_Queue *q, const void *element)
+{
+    OS_SemaphoreWait(&q->roomLeft);
+    OS_queueCopyIn(q, element);
+    OS_SemaphoreSignal(&q->currentSize);
+}
+
+void OS_QueueGet(OS_Queue *q, void *element)
+{
+    OS_SemaphoreWait(&q->currentSize);
+    OS_queueCopyOut(q, element);
+    OS_SemaphoreSignal(&q->roomLeft);
+}
+
+OS_Err OS_QueueTryPut(OS_Queue *q, const void *element)
+{
+    if (!OS_SemaphoreTryWait(&q->roomLeft))
+    {
+        return OS_ERR_QUEUE_FULL;
+    }
+    OS_queueCopyIn(q, element);
+    OS_queueSignal(&q->currentSize);
+    return OS_ERR_NONE;
+}
+
+OS_Err OS_QueueTryGet(OS_Queue *q, void *element)
+{
+    if (!OS_SemaphoreTryWait(&q->currentSize))
+    {
+        return OS_ERR_QUEUE_EMPTY;
+    }
+    OS_queueCopyOut(q, element);
+    OS_queueSignal(&q->roomLeft);
+    return OS_ERR_NONE;
+}
+
+#if OS_CONFIG_SLEEP
+OS_Err OS_QueuePutTimeout(OS_Queue *q, const void *element, uint32_t timeoutMs)
+{
+    if (OS_SemaphoreWaitTimeout(&q->roomLeft, timeoutMs) != OS_ERR_NONE)
+    {
+        return OS_ERR_TIMEOUT;
+    }
+    OS_queueCopyIn(q, element);
+    OS_SemaphoreSignal(&q->currentSize);
+    return OS_ERR_NONE;
+}
+
+OS_Err OS_QueueGetTimeout(OS_Queue *q, void *element, uint32_t timeoutMs)
+{
+    if (OS_SemaphoreWaitTimeout(&q->currentSize, timeoutMs) != OS_ERR_NONE)
+    {
+        return OS_ERR_TIMEOUT;
+    }
+    OS_queueCopyOut(q, element);
+    OS_SemaphoreSignal(&q->roomLeft);
+    return OS_ERR_NONE;
+}
+#endif
+
+static void OS_queueCopyIn(OS_Queue *q, const void *element)
+{
+    IntMasterDisable();
+    memcpy(&q->buffer[q->putIdx * q->elementSize], element, q->elementSize);
+    q->putIdx++;
+    if (q->putIdx == q->capacity)
+    {
+        // wrap
+        q->putIdx = 0;
+    }
+    IntMasterEnable();
+}
+
+static void OS_queueCopyOut(OS_Queue *q, void *element)
+{
+    IntMasterDisable();
+    memcpy(element, &q->buffer[q->getIdx * q->elementSize], q->elementSize);
+    q->getIdx++;
+    if (q->getIdx == q->capacity)
+    {
+        // wrap
+        q->getIdx = 0;
+    }
+    IntMasterEnable();
+}
+
+static void OS_queueSignal(int32_t *s)
+{
+    if (OS_IsInterruptContext())
+    {
+        OS_SemaphoreSignalFromISR(s);
+    }
+    else
+    {
+        OS_SemaphoreSignal(s);
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+//*****************************************************************************
+//
+// Blocking FIFO queues with caller-provided storage, used to pass elements
+//   of any size from producer threads to consumer threads.
+// Each queue has its own pair of semaphores: producers suspend when the queue
+//   is full, and consumers suspend when the queue is empty.
+// Elements are copied in and out of the queue with `memcpy`, inside a short
+//   critical section, so that the non-blocking `OS_QueueTryPut` and
+//   `OS_QueueTryGet` can be called from ISRs as well; the woken-up thread
+//   runs as soon as the ISR returns, if it outranks the interrupted one.
+//
+// Usage:
+// ```c
+// #include "os-queue.h"
+//
+// typedef struct Sample { uint16_t channel; uint16_t value; } Sample;
+// static Sample adcSamples[16];
+// static OS_Queue adcQueue;
+//
+// OS_QueueInit(&adcQueue, adcSamples, sizeof(Sample), 16);
+//
+// Sample sample = {0, 1234};
+// OS_QueuePut(&adcQueue, &sample);                          // blocking
+// OS_Err err = OS_QueueTryPut(&adcQueue, &sample);          // OS_ERR_QUEUE_FULL
+// err = OS_QueueGetTimeout(&adcQueue, &sample, 100);        // OS_ERR_TIMEOUT
+// ```
+//
+//*****************************************************************************
+
+#ifndef OS_QUEUE_H_INCLUDED
+#define OS_QUEUE_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+
+typedef struct OS_Queue
+{
+    uint8_t *buffer;      // caller-provided storage of `capacity` elements
+    uint32_t elementSize; // size of each element in bytes
+    uint32_t capacity;    // maximum number of elements
+    uint32_t putIdx;      // index of the next element to be written
+    uint32_t getIdx;      // index of the next element to be read
+    int32_t currentSize;  // semaphore counting the elements in the queue
+    int32_t roomLeft;     // semaphore counting the free slots in the queue
+} OS_Queue;
+
+//
+// Define a queue at compile time, along with its storage, in the
+//   `.os_objects` section. No call to OS_QueueInit is needed:
+//
+// ```c
+// OS_QUEUE_DEFINE(adcQueue, Sample, 16); // OS_Queue adcQueue, Sample adcQueueStorage[16]
+// ```
+//
+#define OS_QUEUE_DEFINE(queueName, elementType, queueCapacity) \
+    OS_SECTION(".os_objects")                                  \
+    elementType queueName##Storage[queueCapacity];             \
+    OS_SECTION(".os_objects")                                  \
+    OS_Queue queueName = {                                     \
+        .buffer = (uint8_t *)queueName##Storage,               \
+        .elementSize = sizeof(elementType),                    \
+        .capacity = (queueCapacity),                           \
+        .putIdx = 0,                                           \
+        .getIdx = 0,                                           \
+        .currentSize = 0,                                      \
+        .roomLeft = (queueCapacity)}
+
+#if OS_CONFIG_SEMAPHORES
+void OS_QueueInit(OS_Queue *q, void *buffer, uint32_t elementSize, uint32_t capacity);
+void OS_QueuePut(OS_Queue *q, const void *element);
+void OS_QueueGet(OS_Queue *q, void *element);
+OS_Err OS_QueueTryPut(OS_Queue *q, const void *element);
+OS_Err OS_QueueTryGet(OS_Queue *q, void *element);
+#if OS_CONFIG_SLEEP
+OS_Err OS_QueuePutTimeout(OS_Queue *q, const void *element, uint32_t timeoutMs);
+OS_Err OS_QueueGetTimeout(OS_Queue *q, void *element, uint32_t timeoutMs);
+#endif
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <driverlib/interrupt.h>
+#include "os.h"
+
+#include "os-stream-buffer.h"
+
+#if OS_CONFIG_SEMAPHORES
+
+//
+// The fn OS_streamTriggered returns whether the reader should be woken up.
+// A full buffer wakes the reader too, whatever the trigger level.
+// It must be called with interrupts disabled.
+//
+static bool OS_streamTriggered(OS_StreamBuffer *sb);
+
+//
+// The fn OS_streamDelimitersCount returns how many delimiters are found
+//   in `len` bytes.
+//
+static uint32_t OS_streamDelimitersCount(const uint8_t *bytes, uint32_t len, int32_t delimiter);
+
+//
+// The fn OS_streamCopyOut moves up to `len` bytes out of the buffer and
+//   returns how many were moved.
+//
+static uint32_t OS_streamCopyOut(OS_StreamBuffer *sb, uint8_t *data, uint32_t len);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void OS_StreamBufferInit(OS_StreamBuffer *sb, void *buffer, uint32_t capacity, uint32_t triggerLevel, int32_t delimiter)
+{
+    sb->buffer = buffer;
+    sb->capacity = capacity;
+    sb->putIdx = 0;
+    sb->getIdx = 0;
+    sb->count = 0;
+    sb->triggerLevel = triggerLevel;
+    sb->delimiter = delimiter;
+    sb->delimitersCount = 0;
+    sb->readerWaiting = false;
+    sb->dataReady = 0;
+}
+
+uint32_t OS_StreamBufferWrite(OS_StreamBuffer *sb, const void *data, uint32_t len)
+{
+    const uint8_t *bytes = data;
+
+    IntMasterDisable();
+    uint32_t roomLeft = sb->capacity - sb->count;
+    if (len > roomLeft)
+    {
+        len = roomLeft;
+    }
+
+    uint32_t firstChunk = sb->capacity - sb->putIdx;
+    if (firstChunk > len)
+    {
+        firstChunk = len;
+    }
+    memcpy(&sb->buffer[sb->putIdx], bytes, firstChunk);
+    memcpy(&sb->buffer[0], &bytes[firstChunk], len - firstChunk);
+    sb->putIdx += len;
+    if (sb->putIdx >= sb->capacity)
+    {
+        // wrap
+        sb->putIdx -= sb->capacity;
+    }
+    sb->count += len;
+    sb->delimitersCount += OS_streamDelimitersCount(bytes, len, sb->delimiter);
+
+    bool wakeReader = sb->readerWaiting && OS_streamTriggered(sb);
+    if (wakeReader)
+    {
+        sb->readerWaiting = false;
+    }
+    IntMasterEnable();
+
+    if (wakeReader && OS_IsInterruptContext())
+    {
+        // switch to the reader on return only if it outranks the running thread
+        OS_SemaphoreSignalFromISR(&sb->dataReady);
+    }
+    else if (wakeReader)
+    {
+        OS_SemaphoreSignal(&sb->dataReady);
+    }
+    return len;
+}
+
+uint32_t OS_StreamBufferRead(OS_StreamBuffer *sb, void *data, uint32_t len)
+{
+    IntMasterDisable();
+    // a signal left over by a timed-out read can wake the reader early
+    while (!OS_streamTriggered(sb))
+    {
+        sb->readerWaiting = true;
+        IntMasterEnable();
+        OS_SemaphoreWait(&sb->dataReady);
+        IntMasterDisable();
+    }
+    IntMasterEnable();
+    return OS_streamCopyOut(sb, data, len);
+}
+
+#if OS_CONFIG_SLEEP
+uint32_t OS_StreamBufferReadTimeout(OS_StreamBuffer *sb, void *data, uint32_t len, uint32_t timeoutMs)
+{
+    IntMasterDisable();
+    if (!OS_streamTriggered(sb))
+    {
+        sb->readerWaiting = true;
+        IntMasterEnable();
+        OS_SemaphoreWaitTimeout(&sb->dataReady, timeoutMs);
+
+        // either way, the reader isn't waiting anymore: drop the signal that
+        //   may have been sent right after the timeout
+        IntMasterDisable();
+        sb->readerWaiting = false;
+        sb->dataReady = 0;
+    }
+    IntMasterEnable();
+    return OS_streamCopyOut(sb, data, len);
+}
+#endif
+
+uint32_t OS_StreamBufferBytesAvailable(OS_StreamBuffer *sb)
+{
+    return sb->count;
+}
+
+static bool OS_streamTriggered(OS_StreamBuffer *sb)
+{
+    return sb->count >= sb->triggerLevel || sb->count == sb->capacity || sb->delimitersCount > 0;
+}
+
+static uint32_t OS_streamDelimitersCount(const uint8_t *bytes, uint32_t len, int32_t delimiter)
+{
+    if (delimiter == OS_STREAMBUFFER_NO_DELIMITER)
+    {
+        return 0;
+    }
+
+    uint32_t delimiters = 0;
+    const uint8_t *found;
+    while ((found = memchr(bytes, delimiter, len)))
+    {
+        delimiters++;
+        len -= found + 1 - bytes;
+        bytes = found + 1;
+    }
+    return delimiters;
+}
+
+static uint32_t OS_streamCopyOut(OS_StreamBuffer *sb, uint8_t *data, uint32_t len)
+{
+    IntMasterDisable();
+    if (len > sb->count)
+    {
+        len = sb->count;
+    }
+
+    uint32_t firstChunk = sb->capacity - sb->getIdx;
+    if (firstChunk > len)
+    {
+        firstChunk = len;
+    }
+    memcpy(data, &sb->buffer[sb->getIdx], firstChunk);
+    memcpy(&data[firstChunk], &sb->buffer[0], len - firstChunk);
+    sb->getIdx += len;
+    if (sb->getIdx >= sb->capacity)
+    {
+        // wrap
+        sb->getIdx -= sb->capacity;
+    }
+    sb->count -= len;
+    sb->delimitersCount -= OS_streamDelimitersCount(data, len, sb->delimiter);
+    IntMasterEnable();
+    return len;
+}
+
+#endif
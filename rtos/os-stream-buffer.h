@@ -0,0 +1,92 @@
+//*****************************************************************************
+//
+// Byte stream buffers with caller-provided storage, used to pass a stream of
+//   bytes, e.g. from the UART RX ISR, to a single consumer thread.
+// Unlike `OS_Queue`, which signals a semaphore for every element, the writer
+//   wakes the consumer only once the trigger condition is met: at least
+//   `triggerLevel` bytes are available, or the `delimiter` byte has arrived.
+// Bytes are copied in and out in bulk, with at most two `memcpy` per call
+//   (one when the copy wraps around the end of the storage).
+//
+// `OS_StreamBufferWrite` never blocks, so it can be called from ISRs; bytes
+//   that don't fit are dropped, and the number of bytes written is returned.
+//   From an ISR, the reader runs as soon as the ISR returns, if it outranks
+//   the interrupted thread.
+// There must be one reader at a time.
+//
+// Usage:
+// ```c
+// #include "os-stream-buffer.h"
+//
+// static uint8_t rxStorage[128];
+// static OS_StreamBuffer rxStream;
+//
+// OS_StreamBufferInit(&rxStream, rxStorage, 128, 16, '\n'); // wake on 16 bytes or a newline
+//
+// OS_StreamBufferWrite(&rxStream, bytes, len);              // from the UART ISR
+//
+// uint8_t line[32];
+// uint32_t len = OS_StreamBufferRead(&rxStream, line, 32);  // blocking
+// len = OS_StreamBufferReadTimeout(&rxStream, line, 32, 5); // whatever arrived within 5ms
+// ```
+//
+//*****************************************************************************
+
+#ifndef OS_STREAM_BUFFER_H_INCLUDED
+#define OS_STREAM_BUFFER_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+
+#define OS_STREAMBUFFER_NO_DELIMITER -1
+
+typedef struct OS_StreamBuffer
+{
+    uint8_t *buffer;          // caller-provided storage of `capacity` bytes
+    uint32_t capacity;        // maximum number of bytes
+    uint32_t putIdx;          // index of the next byte to be written
+    uint32_t getIdx;          // index of the next byte to be read
+    uint32_t count;           // number of bytes in the buffer
+    uint32_t triggerLevel;    // bytes needed to wake the reader
+    int32_t delimiter;        // byte that wakes the reader, or OS_STREAMBUFFER_NO_DELIMITER
+    uint32_t delimitersCount; // number of delimiters in the buffer
+    bool readerWaiting;       // whether the reader is, or is about to be, suspended
+    int32_t dataReady;        // semaphore the reader waits on
+} OS_StreamBuffer;
+
+//
+// Define a stream buffer at compile time, along with its storage, in the
+//   `.os_objects` section. No call to OS_StreamBufferInit is needed:
+//
+// ```c
+// OS_STREAM_BUFFER_DEFINE(rxStream, 128, 16, '\n'); // OS_StreamBuffer rxStream, uint8_t rxStreamStorage[128]
+// ```
+//
+#define OS_STREAM_BUFFER_DEFINE(streamName, streamCapacity, streamTriggerLevel, streamDelimiter) \
+    OS_SECTION(".os_objects")                                                                  \
+    uint8_t streamName##Storage[streamCapacity];                                               \
+    OS_SECTION(".os_objects")                                                                  \
+    OS_StreamBuffer streamName = {                                                             \
+        .buffer = streamName##Storage,                                                         \
+        .capacity = (streamCapacity),                                                          \
+        .putIdx = 0,                                                                           \
+        .getIdx = 0,                                                                           \
+        .count = 0,                                                                            \
+        .triggerLevel = (streamTriggerLevel),                                                  \
+        .delimiter = (streamDelimiter),                                                        \
+        .delimitersCount = 0,                                                                  \
+        .readerWaiting = false,                                                                \
+        .dataReady = 0}
+
+#if OS_CONFIG_SEMAPHORES
+void OS_StreamBufferInit(OS_StreamBuffer *sb, void *buffer, uint32_t capacity, uint32_t triggerLevel, int32_t delimiter);
+uint32_t OS_StreamBufferWrite(OS_StreamBuffer *sb, const void *data, uint32_t len);
+uint32_t OS_StreamBufferRead(OS_StreamBuffer *sb, void *data, uint32_t len);
+#if OS_CONFIG_SLEEP
+uint32_t OS_StreamBufferReadTimeout(OS_StreamBuffer *sb, void *data, uint32_t len, uint32_t timeoutMs);
+#endif
+uint32_t OS_StreamBufferBytesAvailable(OS_StreamBuffer *sb);
+#endif
+
+#endif
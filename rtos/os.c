@@ -0,0 +1,1013 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <inc/hw_ints.h>
+#include <inc/hw_memmap.h>
+#include <inc/tm4c123gh6pm.h>
+#include <driverlib/interrupt.h>
+#include <driverlib/sysctl.h>
+#include <driverlib/timer.h>
+#include "macro-utils.h"
+#include "dwt0.h"
+#include "mpu0.h"
+#include "systick0.h"
+#include "timer0.h"
+#include "os-event-tasks.h"
+
+#include "os.h"
+
+#if OS_CONFIG_EVENT_TASKS && !OS_CONFIG_SEMAPHORES
+#error "OS_CONFIG_EVENT_TASKS needs OS_CONFIG_SEMAPHORES"
+#endif
+
+#if OS_CONFIG_THREAD_CREATE_KILL
+// TCBs and stacks used by OS_ThreadCreate.
+// Being zero-initialized, all TCBs start with status `TCBStateFree`.
+TCB tcbs[MAXNUMTHREADS];
+int32_t stacks[MAXNUMTHREADS][STACKSIZE];
+#endif
+
+// Pointer to the currently running thread.
+TCB *runPt;
+
+//
+// Boundaries of the `.os_tcbs` section, where OS_THREAD_DEFINE places the TCBs
+//   of the threads defined at compile time. See `blinky_ccs.cmd`.
+//
+extern TCB __OS_TCBS_START;
+extern TCB __OS_TCBS_END;
+
+//
+// The fn OS_Init sets the clock, then initializes SysTick and Timer0.
+// Finally, it links the threads defined with OS_THREAD_DEFINE and, if
+//   `firstTask` isn't null, creates one more thread for it.
+// Without OS_CONFIG_THREAD_CREATE_KILL, `firstTask` must be null.
+//
+void OS_Init(
+    uint32_t schedulerFrequencyHz,
+    void (*firstTask)(void),
+    uint8_t priority,
+    const char *name);
+
+//
+// The fn OS_Launch enables SysTick and Timer0, then calls OSAsm_Start,
+//   which starts the first thread.
+//
+void OS_Launch(void);
+
+//
+// The fn OSAsm_Start, defined in os-asm.s, is called by OS_Launch once.
+// It "restores" the first thread's stack on the main stack.
+//
+extern void OSAsm_Start(void);
+
+//
+// The fn OSAsm_ThreadSwitch, defined in os-asm.s, is periodically called
+//   by SysTick (ISR).
+// It preemptively switches to the next thread, that is, it stores the stack
+//   of the running thread and restores the stack of the next thread.
+// It calls OS_Schedule to decide which thread is run next and update `runPt`.
+//
+extern void OSAsm_ThreadSwitch(void);
+
+//
+// The fn OS_Scheduler is called by OSAsm_ThreadSwitch and is responsible
+//   for deciding the thread that is run next.
+//
+void OS_Scheduler(void);
+
+//
+// The fn OS_threadIsReady returns whether a thread is neither sleeping nor
+//   blocked, that is, whether OS_Scheduler may pick it.
+//
+static inline bool OS_threadIsReady(TCB *tcb);
+
+#if OS_CONFIG_CYCLES_ACCOUNTING
+//
+// The fn OS_Scheduler also adds the cycles spent by the thread switched out
+//   to its `runCycles`; `switchInCycles` holds when the running thread was
+//   switched in.
+//
+static uint32_t switchInCycles = 0;
+#endif
+
+#if OS_CONFIG_STACK_GUARD
+//
+// The fn OS_Scheduler also moves the MPU stack guard to the bottom of the
+//   stack of the thread that is run next.
+// The fn OS_faultIntHandler replaces FaultISR: if the fault was caused by
+//   the running thread writing into its stack guard, it saves the thread's
+//   TCB in `OS_StackOverflowThread`, for the debugger to inspect.
+//
+TCB *volatile OS_StackOverflowThread = 0;
+static void OS_faultIntHandler(void);
+#endif
+
+#if OS_CONFIG_THREAD_CREATE_KILL
+//
+// The fn OS_setInitialStack sets up the stack for a new thread as if it had
+//   already been running and then suspended.
+//
+static void OS_setInitialStack(TCB *tcb, int32_t *stack, uint32_t stackSize, void (*task)(void));
+#endif
+
+//
+// The fn OS_tcbLink adds a TCB to the circular linked list, right after
+//   `runPt`. The first TCB linked establishes the list and becomes `runPt`,
+//   that is, it's the first thread run by OS_Launch.
+// It must be called with interrupts disabled.
+//
+static void OS_tcbLink(TCB *tcb);
+
+//
+// The fn OS_staticThreadsLink adds the TCBs found in the `.os_tcbs` section
+//   to the circular linked list. Being already fully initialized, including
+//   their stacks, painting and linking them is the only work left at startup.
+// Each TCB is linked after the previous one, so that round-robin runs the
+//   threads in the order they're defined with OS_THREAD_DEFINE.
+//
+static void OS_staticThreadsLink(void);
+
+#if OS_CONFIG_THREAD_CREATE_KILL
+//
+// The fn OS_ThreadCreate adds a new thread to the circular linked list of TCBs,
+//   then runs it. It fails if all the TCBs are already active.
+// The fn can be called both:
+//   * before the OS is launched (but after OS_Init);
+//   * after the OS is launched (by a running thread).
+// The thread that calls this function keeps running until the end
+//   of its scheduled time-slice. The new thread is run next.
+//
+OS_Err OS_ThreadCreate(void (*task)(void), uint8_t priority, const char *name);
+
+//
+// The fn OS_ThreadKill kills the thread that calls it, then starts the thread
+//   scheduled next. It fails if the last active thread tries to kill itself.
+//
+OS_Err OS_ThreadKill(void);
+#endif
+
+//
+// The fn OS_ThreadSelfGet returns the TCB of the thread that calls it.
+//
+TCB *OS_ThreadSelfGet(void);
+
+//
+// The fn OS_ThreadsGet fills `threads` with the TCBs of the threads in the
+//   circular linked list, starting from the running one, followed by the
+//   idle thread. It returns how many were written, at most `maxThreads`.
+// It's meant for diagnostics: the TCBs may change as soon as it returns.
+//
+uint32_t OS_ThreadsGet(TCB **threads, uint32_t maxThreads);
+
+//
+// Stacks are painted with `OS_STACK_PAINT` when their thread is created, or
+//   by OS_Init for the threads defined at compile time.
+// The fn OS_ThreadStackUnusedGet returns how many words at the bottom of the
+//   stack still hold the paint, that is, have never been used: the lower
+//   this high-water mark gets, the closer the thread came to overflowing.
+// The bottom `OS_STACK_GUARD_WORDS` may be taken by the MPU guard, so they
+//   are neither painted nor counted.
+//
+#define OS_STACK_PAINT 0xA5A5A5A5
+#define OS_STACK_GUARD_WORDS 15
+static void OS_stackPaint(TCB *tcb);
+uint32_t OS_ThreadStackUnusedGet(TCB *thread);
+
+//
+// The fn OS_ThreadArenaSet gives `thread` its own arena, see `arena.h`, for
+//   scratch memory that doesn't need locking, since no other thread uses it.
+// The fn OS_ThreadArenaGet returns the arena of the thread that calls it,
+//   null if it has none.
+//
+void OS_ThreadArenaSet(TCB *thread, Arena *arena);
+Arena *OS_ThreadArenaGet(void);
+
+#if OS_CONFIG_PRIORITY_SCHEDULER
+//
+// The fn OS_ThreadSetPriority changes the priority of a thread, and runs
+//   the scheduler if another thread should now be running.
+// If the thread is boosted, the new priority applies once the boost ends.
+//
+void OS_ThreadSetPriority(TCB *thread, uint8_t priority);
+
+//
+// The fn OS_ThreadSetBoost sets the priority a thread is temporarily boosted
+//   to when woken up by a semaphore signaled from an ISR. 255 disables it.
+// The boost lasts until the thread is switched out, that is, until it waits,
+//   sleeps, suspends, or uses up its time-slice: OS_Scheduler then restores
+//   `basePriority`.
+//
+void OS_ThreadSetBoost(TCB *thread, uint8_t boostPriority);
+#endif
+
+#if OS_CONFIG_CYCLES_ACCOUNTING
+//
+// The fn OS_ThreadCyclesGet returns the clock cycles a thread has spent
+//   running, including the ISRs that interrupted it. The counter wraps
+//   around, so only differences between two readings are meaningful.
+//
+uint32_t OS_ThreadCyclesGet(TCB *thread);
+#endif
+
+//
+// The fn OS_IsInterruptContext returns whether the processor is running
+//   an ISR (handler mode).
+//
+bool OS_IsInterruptContext(void);
+
+//
+// The fn OS_ThreadSuspend halts the current thread and switches to the next.
+// It's called by the running thread itself.
+//
+void OS_ThreadSuspend(void);
+
+#if OS_CONFIG_SLEEP
+//
+// The fn OS_ThreadSleep makes the current thread dormant for a specified time.
+// It's called by the running thread itself.
+// The fn OS_decrementTcbsSleepValue is called by Timer0 every ms and decrements
+//   the value of `sleep` on the TCBs in the circular linked list.
+// A thread that is still blocked when its `sleep` reaches 0 was waiting on
+//   a semaphore with a timeout: it's unblocked and marked as timed out.
+//
+void OS_ThreadSleep(uint32_t ms);
+static void OS_decrementTcbsSleepValue(void);
+
+//
+// The monotonic counter `ticks` is incremented by Timer0 every ms, before
+//   the `sleep` values are decremented. It wraps around after ~49 days.
+// The fn OS_TicksGet returns its value.
+//
+static volatile uint32_t ticks = 0;
+uint32_t OS_TicksGet(void);
+
+//
+// The fn OS_ThreadSleepUntil makes the current thread dormant until
+//   `*lastWakeTicks + periodMs`, then advances `*lastWakeTicks` by `periodMs`.
+// Unlike OS_ThreadSleep, the wake-up times don't drift with the time spent
+//   working between two calls, so periodic threads hold their rate.
+// If the wake-up time has already passed, it returns immediately.
+// `*lastWakeTicks` should be initialized with OS_TicksGet.
+//
+void OS_ThreadSleepUntil(uint32_t *lastWakeTicks, uint32_t periodMs);
+#endif
+
+#if OS_IDLE_THREAD
+//
+// The idle thread is owned by the kernel and isn't part of the circular
+//   linked list of TCBs: OS_Scheduler falls back to it when every thread
+//   is either sleeping or blocked.
+// The fn OS_idleThread calls the optional user hook, then puts the processor
+//   to sleep until the next interrupt. With OS_CONFIG_CYCLES_ACCOUNTING, it
+//   accumulates the sleeping cycles in `idleCycles`.
+// Its TCB lives in `.os_tcbs` too, which is therefore never empty, but
+//   OS_staticThreadsLink skips it.
+//
+static void OS_idleThread(void);
+OS_THREAD_DEFINE(OS_Idle, OS_idleThread, 255, IDLESTACKSIZE);
+static void (*idleHook)(void) = 0;
+
+//
+// The fn OS_SetIdleHook registers a function the idle thread calls before
+//   putting the processor to sleep. The hook must never block or sleep.
+//
+void OS_SetIdleHook(void (*hook)(void));
+#endif
+
+#if OS_CONFIG_SLEEP && OS_CONFIG_CYCLES_ACCOUNTING
+#define OS_IDLE_PERCENT 1
+static volatile uint32_t idleCycles = 0;
+static uint32_t idlePercent = 0;
+static uint32_t idleWindowStart = 0;
+
+//
+// The fn OS_updateIdlePercent is called by Timer0 every ms and, once every
+//   `IDLEWINDOWMS`, converts the accumulated idle cycles into a percentage.
+// It does the same for the cycles each thread has been running, idle thread
+//   included, which OS_ThreadCpuPercentGet returns.
+//
+static void OS_updateIdlePercent(void);
+static void OS_cpuPercentUpdate(TCB *tcb, uint32_t now, uint32_t windowCycles);
+uint32_t OS_ThreadCpuPercentGet(TCB *thread);
+
+//
+// The fn OS_GetIdlePercent returns the percentage of time the processor spent
+//   idle during the last measurement window; 100 minus this value is the
+//   CPU load.
+//
+uint32_t OS_GetIdlePercent(void);
+#else
+#define OS_IDLE_PERCENT 0
+#endif
+
+#if OS_CONFIG_SEMAPHORES
+//
+// The fn OS_SemaphoreWait decrements the semaphore counter.
+// If the new counter's value is < 0, it marks the current thread as blocked
+//   and switches to the next one.
+//
+void OS_SemaphoreWait(int32_t *s);
+
+#if OS_CONFIG_SLEEP
+//
+// The fn OS_SemaphoreWaitTimeout is like OS_SemaphoreWait, but gives up
+//   waiting after `timeoutMs` and returns OS_ERR_TIMEOUT.
+// The timeout reuses the thread's `sleep` countdown, so no polling is involved:
+//   the thread isn't run until either the semaphore is signaled or Timer0
+//   counts the timeout down to 0.
+// With a timeout of 0, it returns immediately.
+//
+OS_Err OS_SemaphoreWaitTimeout(int32_t *s, uint32_t timeoutMs);
+#endif
+
+//
+// The fn OS_SemaphoreTryWait decrements the semaphore counter only if it's
+//   positive, and never blocks. It returns whether the counter was decremented.
+// It can be called by both threads and ISRs.
+//
+bool OS_SemaphoreTryWait(int32_t *s);
+
+//
+// The fn OS_SemaphoreSignal increments the semaphore counter.
+// If the new counter's value is <= 0, it wakes up the next thread blocked
+//   on that semaphore, cancelling its timeout, if any.
+// When called from an ISR, the woken thread is boosted to its `boostPriority`.
+//
+void OS_SemaphoreSignal(int32_t *s);
+
+//
+// The fn OS_SemaphoreSignalFromISR is OS_SemaphoreSignal for ISRs, followed
+//   by a switch only if needed: the switch is pended if the woken thread
+//   outranks the running one, once boosted, or if the processor is idle.
+// The pended SysTick runs when the ISR returns, so several signals in the
+//   same ISR cost a single switch. It returns whether a switch was pended.
+// Each call that doesn't pend a new switch is counted as saved, against the
+//   old practice of calling OS_ThreadSuspend after every signal in an ISR.
+//
+static uint32_t isrSwitchesPended = 0;
+static uint32_t isrSwitchesSaved = 0;
+bool OS_SemaphoreSignalFromISR(int32_t *s);
+uint32_t OS_ISRSwitchesPendedGet(void);
+uint32_t OS_ISRSwitchesSavedGet(void);
+
+//
+// The fn OS_semaphoreWake does the work of OS_SemaphoreSignal, with
+//   interrupts disabled, and returns the woken thread, if any.
+//
+static TCB *OS_semaphoreWake(int32_t *s);
+#endif
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+void OS_Init(
+    uint32_t schedulerFrequencyHz,
+    void (*firstTask)(void),
+    uint8_t priority,
+    const char *name)
+{
+    SysCtlClockSet(SYSCTL_SYSDIV_1 | SYSCTL_USE_OSC | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ);
+    SysTick0_Init(schedulerFrequencyHz, OSAsm_ThreadSwitch);
+#if OS_CONFIG_SLEEP
+    Timer0_Init1KHz(OS_decrementTcbsSleepValue);
+#endif
+#if OS_CONFIG_CYCLES_ACCOUNTING
+    Dwt0_Init();
+#endif
+#if OS_CONFIG_STACK_GUARD
+    Mpu0_Init();
+    IntRegister(FAULT_HARD, OS_faultIntHandler);
+#endif
+#if OS_CONFIG_EVENT_TASKS
+    OS_EventTasksInit();
+#endif
+    OS_staticThreadsLink();
+#if OS_CONFIG_THREAD_CREATE_KILL
+    if (firstTask)
+    {
+        OS_ERRCHECK(OS_ThreadCreate(firstTask, priority, name));
+    }
+#else
+    ASSERT(firstTask == 0);
+#endif
+}
+
+void OS_Launch(void)
+{
+    ASSERT(runPt);
+#if OS_CONFIG_CYCLES_ACCOUNTING
+    switchInCycles = Dwt0_CyclesGet();
+#endif
+#if OS_IDLE_PERCENT
+    idleWindowStart = switchInCycles;
+#endif
+    SysTick0_Enable();
+#if OS_CONFIG_SLEEP
+    Timer0_Enable();
+#endif
+#if OS_CONFIG_STACK_GUARD
+    Mpu0_StackGuardSet(runPt->stackBase);
+#endif
+    OSAsm_Start();
+}
+
+void OS_Scheduler(void)
+{
+#if OS_CONFIG_CYCLES_ACCOUNTING
+    uint32_t now = Dwt0_CyclesGet();
+    runPt->runCycles += now - switchInCycles;
+    switchInCycles = now;
+#endif
+
+    // runPt is removed from the circular linked list after calling
+    //   OS_ThreadKill, so we start iterating from the next TCB.
+    TCB *iteratingPt = runPt->next;
+#if OS_IDLE_THREAD
+    TCB *bestPt = &OS_Idle;
+#else
+    TCB *bestPt = runPt->next; // every thread is always ready
+#endif
+
+#if OS_CONFIG_PRIORITY_SCHEDULER
+    // a boost lasts until the boosted thread is switched out
+    runPt->priority = runPt->basePriority;
+
+    // search for highest priority thread not sleeping or blocked
+    uint32_t maxPriority = 256;
+    do
+    {
+        if ((iteratingPt->priority < maxPriority) && OS_threadIsReady(iteratingPt))
+        {
+            bestPt = iteratingPt;
+            maxPriority = bestPt->priority;
+        }
+        iteratingPt = iteratingPt->next; // skips at least one
+    } while (iteratingPt != runPt->next);
+#else
+    // Round Robin: search for the next thread not sleeping or blocked
+    do
+    {
+        if (OS_threadIsReady(iteratingPt))
+        {
+            bestPt = iteratingPt;
+            break;
+        }
+        iteratingPt = iteratingPt->next;
+    } while (iteratingPt != runPt->next);
+#endif
+
+#if OS_IDLE_THREAD
+    if (bestPt == &OS_Idle)
+    {
+        // keep a way back into the circular linked list for the next run
+        OS_Idle.next = runPt->next;
+    }
+#endif
+    runPt = bestPt;
+#if OS_CONFIG_STACK_GUARD
+    Mpu0_StackGuardSet(runPt->stackBase);
+#endif
+#if OS_CONFIG_EVENT_TASKS
+    if (runPt == &OS_EventTasks)
+    {
+        OS_EventTasksSwitchIn();
+    }
+#endif
+}
+
+static inline bool OS_threadIsReady(TCB *tcb)
+{
+#if OS_CONFIG_SLEEP
+    if (tcb->sleep)
+        return false;
+#endif
+#if OS_CONFIG_SEMAPHORES
+    if (tcb->blocked)
+        return false;
+#endif
+    return true;
+}
+
+#if OS_CONFIG_STACK_GUARD
+static void OS_faultIntHandler(void)
+{
+    if (Mpu0_IsStackGuardFault(runPt->stackBase))
+    {
+        OS_StackOverflowThread = runPt; // see OS_StackOverflowThread->name
+    }
+    while (1)
+        ;
+}
+#endif
+
+#if OS_CONFIG_THREAD_CREATE_KILL
+static void OS_setInitialStack(TCB *tcb, int32_t *stack, uint32_t stackSize, void (*task)(void))
+{
+    tcb->sp = &stack[stackSize - 16]; // thread stack pointer
+    tcb->stackBase = stack;
+    tcb->stackSize = stackSize;
+    OS_stackPaint(tcb);
+
+    stack[stackSize - 1] = 0x01000000;   // thumb bit (PSR)
+    stack[stackSize - 2] = (int32_t)task; // R15 (PC)
+    stack[stackSize - 3] = 0x14141414;   // R14 (LR)
+    stack[stackSize - 4] = 0x12121212;   // R12
+    stack[stackSize - 5] = 0x03030303;   // R3
+    stack[stackSize - 6] = 0x02020202;   // R2
+    stack[stackSize - 7] = 0x01010101;   // R1
+    stack[stackSize - 8] = 0x00000000;   // R0
+    stack[stackSize - 9] = 0x11111111;   // R11
+    stack[stackSize - 10] = 0x10101010;  // R10
+    stack[stackSize - 11] = 0x09090909;  // R9
+    stack[stackSize - 12] = 0x08080808;  // R8
+    stack[stackSize - 13] = 0x07070707;  // R7
+    stack[stackSize - 14] = 0x06060606;  // R6
+    stack[stackSize - 15] = 0x05050505;  // R5
+    stack[stackSize - 16] = 0x04040404;  // R4
+}
+#endif
+
+static void OS_tcbLink(TCB *tcb)
+{
+    if (runPt == 0)
+    {
+        tcb->next = tcb;
+        runPt = tcb; // this thread will run first
+        return;
+    }
+    tcb->next = runPt->next;
+    runPt->next = tcb;
+}
+
+static void OS_staticThreadsLink(void)
+{
+    IntMasterDisable();
+    TCB *previousTcb = 0;
+    for (TCB *tcb = &__OS_TCBS_START; tcb < &__OS_TCBS_END; tcb++)
+    {
+        OS_stackPaint(tcb);
+#if OS_IDLE_THREAD
+        if (tcb == &OS_Idle)
+            continue;
+#endif
+        if (previousTcb == 0)
+        {
+            OS_tcbLink(tcb);
+        }
+        else
+        {
+            tcb->next = previousTcb->next;
+            previousTcb->next = tcb;
+        }
+        previousTcb = tcb;
+    }
+    IntMasterEnable();
+}
+
+#if OS_CONFIG_THREAD_CREATE_KILL
+OS_Err OS_ThreadCreate(void (*task)(void), uint8_t priority, const char *name)
+{
+    IntMasterDisable();
+    uint32_t newTcbIdx;
+    for (newTcbIdx = 0; newTcbIdx < MAXNUMTHREADS; newTcbIdx++)
+    {
+        if (tcbs[newTcbIdx].status == TCBStateFree)
+            break;
+    }
+    if (newTcbIdx == MAXNUMTHREADS)
+    {
+        return OS_ERR_ALL_TCBS_ACTIVE;
+    }
+
+    tcbs[newTcbIdx].name = name;
+    tcbs[newTcbIdx].sleep = 0;
+    tcbs[newTcbIdx].status = TCBStateActive;
+    tcbs[newTcbIdx].blocked = 0;
+    tcbs[newTcbIdx].timedOut = false;
+    tcbs[newTcbIdx].priority = priority;
+    tcbs[newTcbIdx].basePriority = priority;
+    tcbs[newTcbIdx].boostPriority = 255;
+    tcbs[newTcbIdx].runCycles = 0;
+    tcbs[newTcbIdx].windowCycles = 0;
+    tcbs[newTcbIdx].cpuPercent = 0;
+    tcbs[newTcbIdx].arena = 0;
+
+    OS_setInitialStack(&tcbs[newTcbIdx], stacks[newTcbIdx], STACKSIZE, task);
+    OS_tcbLink(&tcbs[newTcbIdx]);
+
+    IntMasterEnable();
+    return OS_ERR_NONE;
+}
+
+OS_Err OS_ThreadKill(void)
+{
+    if (runPt->next == runPt)
+    {
+        return OS_ERR_KILLING_LAST_ACTIVE_TCB;
+    }
+
+    IntMasterDisable();
+    TCB *previousTcb = runPt;
+    while (1)
+    {
+        previousTcb = previousTcb->next;
+        if (previousTcb->next == runPt)
+            break;
+    }
+    TCB *nextTcb = runPt->next;
+
+    previousTcb->next = nextTcb;
+    runPt->status = TCBStateFree;
+
+    IntMasterEnable();
+    OS_ThreadSuspend();
+
+    // This line shouldn't be reached.
+    // But it doesn't really matter, because the thread is killed anyway.
+    return OS_ERR_NONE;
+}
+#endif
+
+TCB *OS_ThreadSelfGet(void)
+{
+    return runPt;
+}
+
+void OS_ThreadArenaSet(TCB *thread, Arena *arena)
+{
+    thread->arena = arena;
+}
+
+Arena *OS_ThreadArenaGet(void)
+{
+    return runPt->arena;
+}
+
+uint32_t OS_ThreadsGet(TCB **threads, uint32_t maxThreads)
+{
+    uint32_t count = 0;
+    IntMasterDisable();
+    TCB *firstPt = runPt;
+#if OS_IDLE_THREAD
+    if (runPt == &OS_Idle)
+    {
+        firstPt = OS_Idle.next;
+    }
+#endif
+    TCB *iteratingPt = firstPt;
+    do
+    {
+        threads[count++] = iteratingPt;
+        iteratingPt = iteratingPt->next;
+    } while ((iteratingPt != firstPt) && (count < maxThreads));
+#if OS_IDLE_THREAD
+    if (count < maxThreads)
+    {
+        threads[count++] = &OS_Idle;
+    }
+#endif
+    IntMasterEnable();
+    return count;
+}
+
+static void OS_stackPaint(TCB *tcb)
+{
+    // up to the initial stack frame
+    for (uint32_t idx = OS_STACK_GUARD_WORDS; idx < tcb->stackSize - 16; idx++)
+    {
+        tcb->stackBase[idx] = (int32_t)OS_STACK_PAINT;
+    }
+}
+
+uint32_t OS_ThreadStackUnusedGet(TCB *thread)
+{
+    uint32_t idx = OS_STACK_GUARD_WORDS;
+    while ((idx < thread->stackSize) && (thread->stackBase[idx] == (int32_t)OS_STACK_PAINT))
+    {
+        idx++;
+    }
+    return idx - OS_STACK_GUARD_WORDS;
+}
+
+#if OS_CONFIG_PRIORITY_SCHEDULER
+void OS_ThreadSetPriority(TCB *thread, uint8_t priority)
+{
+    IntMasterDisable();
+    uint8_t oldPriority = thread->basePriority;
+    thread->basePriority = priority;
+    if (thread->priority == oldPriority)
+    {
+        // not boosted
+        thread->priority = priority;
+    }
+    // reschedule if the running thread lowered itself, or if another thread
+    //   was raised above the running one
+    bool mustReschedule = (thread == runPt) ? (priority > oldPriority)
+                                            : (priority < runPt->priority);
+    IntMasterEnable();
+
+    if (mustReschedule)
+    {
+        OS_ThreadSuspend();
+    }
+}
+
+void OS_ThreadSetBoost(TCB *thread, uint8_t boostPriority)
+{
+    thread->boostPriority = boostPriority;
+}
+#endif
+
+#if OS_CONFIG_CYCLES_ACCOUNTING
+uint32_t OS_ThreadCyclesGet(TCB *thread)
+{
+    IntMasterDisable();
+    uint32_t cycles = thread->runCycles;
+    if (thread == runPt)
+    {
+        cycles += Dwt0_CyclesGet() - switchInCycles;
+    }
+    IntMasterEnable();
+    return cycles;
+}
+#endif
+
+bool OS_IsInterruptContext(void)
+{
+    return (NVIC_INT_CTRL_R & NVIC_INT_CTRL_VEC_ACT_M) != 0;
+}
+
+void OS_ThreadSuspend(void)
+{
+    SysTick0_ResetCounter();
+    SysTick0_TriggerInterrupt();
+}
+
+#if OS_CONFIG_SLEEP
+void OS_ThreadSleep(uint32_t ms)
+{
+    runPt->sleep = ms;
+    OS_ThreadSuspend();
+}
+
+uint32_t OS_TicksGet(void)
+{
+    return ticks;
+}
+
+void OS_ThreadSleepUntil(uint32_t *lastWakeTicks, uint32_t periodMs)
+{
+    IntMasterDisable();
+    uint32_t wakeTicks = *lastWakeTicks + periodMs;
+    uint32_t remainingMs = wakeTicks - ticks; // unsigned, safe on wrap-around
+    *lastWakeTicks = wakeTicks;
+    if ((remainingMs == 0) || (remainingMs > periodMs))
+    {
+        // the wake-up time has already passed
+        IntMasterEnable();
+        return;
+    }
+    runPt->sleep = remainingMs;
+    IntMasterEnable();
+    OS_ThreadSuspend();
+}
+
+static void OS_decrementTcbsSleepValue(void)
+{
+    TimerIntClear(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
+    ticks++;
+
+    // Like in OS_Scheduler, runPt may have been removed from the list
+    //   by OS_ThreadKill, so we start iterating from the next TCB.
+    TCB *firstPt = runPt->next;
+    TCB *iteratingPt = firstPt;
+    do
+    {
+        if (iteratingPt->sleep > 0)
+        {
+            iteratingPt->sleep -= 1;
+#if OS_CONFIG_SEMAPHORES
+            if ((iteratingPt->sleep == 0) && (iteratingPt->blocked != 0))
+            {
+                // timed out: give back the slot taken on the semaphore
+                (*iteratingPt->blocked) = (*iteratingPt->blocked) + 1;
+                iteratingPt->blocked = 0;
+                iteratingPt->timedOut = true;
+            }
+#endif
+        }
+        iteratingPt = iteratingPt->next;
+    } while (iteratingPt != firstPt);
+
+#if OS_IDLE_PERCENT
+    OS_updateIdlePercent();
+#endif
+}
+#endif
+
+#if OS_IDLE_THREAD
+static void OS_idleThread(void)
+{
+    while (1)
+    {
+        if (idleHook)
+        {
+            idleHook();
+        }
+
+#if OS_IDLE_PERCENT
+        // With interrupts masked, a pending interrupt still wakes up the
+        //   processor, but its ISR is run only after the sleep is accounted.
+        IntMasterDisable();
+        uint32_t sleepStart = Dwt0_CyclesGet();
+        SysCtlSleep();
+        idleCycles += Dwt0_CyclesGet() - sleepStart;
+        IntMasterEnable();
+#else
+        SysCtlSleep();
+#endif
+    }
+}
+
+void OS_SetIdleHook(void (*hook)(void))
+{
+    idleHook = hook;
+}
+#endif
+
+#if OS_IDLE_PERCENT
+static void OS_updateIdlePercent(void)
+{
+    static uint32_t windowMs = 0;
+    windowMs++;
+    if (windowMs < IDLEWINDOWMS)
+        return;
+
+    uint32_t now = Dwt0_CyclesGet();
+    uint32_t windowCycles = now - idleWindowStart;
+    idlePercent = idleCycles / (windowCycles / 100);
+
+    // Like in OS_decrementTcbsSleepValue, start iterating from the next TCB.
+    TCB *firstPt = runPt->next;
+    TCB *iteratingPt = firstPt;
+    do
+    {
+        OS_cpuPercentUpdate(iteratingPt, now, windowCycles);
+        iteratingPt = iteratingPt->next;
+    } while (iteratingPt != firstPt);
+    OS_cpuPercentUpdate(&OS_Idle, now, windowCycles);
+
+    idleCycles = 0;
+    idleWindowStart = now;
+    windowMs = 0;
+}
+
+static void OS_cpuPercentUpdate(TCB *tcb, uint32_t now, uint32_t windowCycles)
+{
+    uint32_t cycles = tcb->runCycles;
+    if (tcb == runPt)
+    {
+        cycles += now - switchInCycles;
+    }
+    tcb->cpuPercent = (cycles - tcb->windowCycles) / (windowCycles / 100);
+    tcb->windowCycles = cycles;
+}
+
+uint32_t OS_ThreadCpuPercentGet(TCB *thread)
+{
+    return thread->cpuPercent;
+}
+
+uint32_t OS_GetIdlePercent(void)
+{
+    return idlePercent;
+}
+#endif
+
+#if OS_CONFIG_SEMAPHORES
+void OS_SemaphoreWait(int32_t *s)
+{
+    IntMasterDisable();
+    (*s) = (*s) - 1;
+    if ((*s) < 0)
+    {
+        runPt->blocked = s; // reason it's blocked
+        IntMasterEnable();
+        OS_ThreadSuspend();
+    }
+    IntMasterEnable();
+}
+
+#if OS_CONFIG_SLEEP
+OS_Err OS_SemaphoreWaitTimeout(int32_t *s, uint32_t timeoutMs)
+{
+    if (timeoutMs == 0)
+    {
+        return OS_SemaphoreTryWait(s) ? OS_ERR_NONE : OS_ERR_TIMEOUT;
+    }
+
+    IntMasterDisable();
+    (*s) = (*s) - 1;
+    if ((*s) < 0)
+    {
+        runPt->blocked = s; // reason it's blocked
+        runPt->sleep = timeoutMs;
+        runPt->timedOut = false;
+        IntMasterEnable();
+        OS_ThreadSuspend();
+        return runPt->timedOut ? OS_ERR_TIMEOUT : OS_ERR_NONE;
+    }
+    IntMasterEnable();
+    return OS_ERR_NONE;
+}
+#endif
+
+bool OS_SemaphoreTryWait(int32_t *s)
+{
+    bool wasTaken = false;
+    IntMasterDisable();
+    if ((*s) > 0)
+    {
+        (*s) = (*s) - 1;
+        wasTaken = true;
+    }
+    IntMasterEnable();
+    return wasTaken;
+}
+
+void OS_SemaphoreSignal(int32_t *s)
+{
+    IntMasterDisable();
+    OS_semaphoreWake(s);
+    IntMasterEnable();
+}
+
+bool OS_SemaphoreSignalFromISR(int32_t *s)
+{
+    IntMasterDisable();
+    TCB *wokenPt = OS_semaphoreWake(s);
+    bool mustSwitch = false;
+    if (wokenPt != 0)
+    {
+        mustSwitch = (runPt == &OS_Idle);
+#if OS_CONFIG_PRIORITY_SCHEDULER
+        mustSwitch = mustSwitch || (wokenPt->priority < runPt->priority);
+#endif
+    }
+    bool isSwitchPending = (NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET) != 0;
+    if (mustSwitch && !isSwitchPending)
+    {
+        isrSwitchesPended++;
+    }
+    else
+    {
+        isrSwitchesSaved++;
+    }
+    IntMasterEnable();
+
+    if (mustSwitch)
+    {
+        OS_ThreadSuspend();
+    }
+    return mustSwitch;
+}
+
+uint32_t OS_ISRSwitchesPendedGet(void)
+{
+    return isrSwitchesPended;
+}
+
+uint32_t OS_ISRSwitchesSavedGet(void)
+{
+    return isrSwitchesSaved;
+}
+
+static TCB *OS_semaphoreWake(int32_t *s)
+{
+    (*s) = (*s) + 1;
+    if ((*s) > 0)
+    {
+        return 0;
+    }
+
+    // search for a TCB blocked on this semaphore and wake it up
+    TCB *aTcb = runPt->next;
+    while (aTcb->blocked != s)
+    {
+        aTcb = aTcb->next;
+    }
+    aTcb->blocked = 0;
+    aTcb->sleep = 0; // cancel the timeout of OS_SemaphoreWaitTimeout
+#if OS_CONFIG_PRIORITY_SCHEDULER
+    if (OS_IsInterruptContext() && (aTcb->boostPriority < aTcb->priority))
+    {
+        aTcb->priority = aTcb->boostPriority;
+    }
+#endif
+    return aTcb;
+}
+#endif
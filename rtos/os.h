@@ -0,0 +1,240 @@
+//*****************************************************************************
+//
+// The RTOS kernel shared by projects 26 to 29.
+// Each project selects the kernel features it needs in its own `os-config.h`,
+//   which is found before this directory on the include path. The features
+//   left out compile to nothing, along with their API:
+//
+//   OS_CONFIG_PRIORITY_SCHEDULER  1: highest priority first, round-robin among
+//                                    equals, with ISR wake-up boost;
+//                                 0: round-robin, priorities are ignored
+//   OS_CONFIG_SEMAPHORES          OS_Semaphore*, `os-queue.h`, `os-stream-buffer.h`,
+//                                    `os-future.h`
+//   OS_CONFIG_SLEEP               OS_ThreadSleep*, OS_TicksGet, timeouts; Timer0
+//   OS_CONFIG_THREAD_CREATE_KILL  OS_ThreadCreate and OS_ThreadKill; without it,
+//                                    threads are defined with OS_THREAD_DEFINE
+//   OS_CONFIG_STACK_GUARD         MPU guard at the bottom of the running stack
+//   OS_CONFIG_CYCLES_ACCOUNTING   OS_ThreadCyclesGet, OS_GetIdlePercent; DWT
+//   OS_CONFIG_EVENT_TASKS         `os-event-tasks.h`, needs semaphores
+//
+// The idle thread exists only if threads can sleep or block.
+// The kernel benchmark, `kernel-benchmark.h`, prints the configuration it
+//   ran with, the context-switch cost, and the size of the kernel's code,
+//   which the linker gathers into the `.os_text` section (see `blinky_ccs.cmd`).
+//
+// Usage:
+// ```c
+// // os-config.h of project 26
+// #define OS_CONFIG_PRIORITY_SCHEDULER 0
+// #define OS_CONFIG_SEMAPHORES 0
+// #define OS_CONFIG_SLEEP 1
+// #define OS_CONFIG_THREAD_CREATE_KILL 0
+// #define OS_CONFIG_STACK_GUARD 0
+// #define OS_CONFIG_CYCLES_ACCOUNTING 0
+// #define OS_CONFIG_EVENT_TASKS 0
+// ```
+//
+//*****************************************************************************
+
+#ifndef OS_H_INCLUDED
+#define OS_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <driverlib/debug.h>
+#include "arena.h"
+#include "os-config.h"
+
+#if !defined(OS_CONFIG_PRIORITY_SCHEDULER) || !defined(OS_CONFIG_SEMAPHORES) ||      \
+    !defined(OS_CONFIG_SLEEP) || !defined(OS_CONFIG_THREAD_CREATE_KILL) ||           \
+    !defined(OS_CONFIG_STACK_GUARD) || !defined(OS_CONFIG_CYCLES_ACCOUNTING) ||      \
+    !defined(OS_CONFIG_EVENT_TASKS)
+#error "os-config.h must define every OS_CONFIG_* feature, either 0 or 1"
+#endif
+
+#define OS_IDLE_THREAD (OS_CONFIG_SLEEP || OS_CONFIG_SEMAPHORES)
+
+#ifndef MAXNUMTHREADS
+#define MAXNUMTHREADS 10 // maximum number of threads created with OS_ThreadCreate
+#endif
+#ifndef STACKSIZE
+#define STACKSIZE 100 // number of 32-bit words in stack, including the MPU guard
+#endif
+#ifndef IDLESTACKSIZE
+#define IDLESTACKSIZE 64 // number of 32-bit words in the idle thread's stack
+#endif
+#ifndef THREADFREQ
+#define THREADFREQ 1000 // maximum time-slice before the scheduler is run, in Hz
+#endif
+#ifndef IDLEWINDOWMS
+#define IDLEWINDOWMS 1000 // time window over which the idle percentage is measured
+#endif
+
+typedef enum OS_Err
+{
+    OS_ERR_NONE = 0,
+    OS_ERR_ALL_TCBS_ACTIVE,
+    OS_ERR_KILLING_LAST_ACTIVE_TCB,
+    OS_ERR_QUEUE_FULL,
+    OS_ERR_QUEUE_EMPTY,
+    OS_ERR_TIMEOUT,
+    OS_ERR_IO,
+} OS_Err;
+
+#define OS_ERRCHECK(expr)              \
+    if (expr != OS_ERR_NONE)           \
+    {                                  \
+        __error__(__FILE__, __LINE__); \
+    }
+
+//
+// TCBState indicates whether the TCB can be used by OS_ThreadCreate
+// to create a new thread.
+//
+enum TCBState
+{
+    TCBStateFree,
+    TCBStateActive
+};
+
+//
+// Thread Control Block
+// Its fields are managed by the kernel; it's exposed only so that
+//   OS_THREAD_DEFINE can emit fully initialized TCBs at compile time.
+// The fields are there whatever the configuration, so that the layout is
+//   the same for every project, but only the enabled features use them.
+// IMPORTANT! The fn OSAsm_Start and OSAsm_ThreadSwitch, defined in os-asm.s,
+//   expect the `sp` field to be placed first in the struct! Don't shuffle it!
+//
+typedef struct TCB
+{
+    int32_t *sp;           // pointer to stack (valid for threads not running)
+    struct TCB *next;      // linked-list pointer
+    const char *name;      // name for simplified debugging
+    uint32_t sleep;        // 0 means not sleeping; timeout while blocked
+    enum TCBState status;  // active or free
+    int32_t *blocked;      // pointer to a semaphore; if null, the thread isn't blocked
+    bool timedOut;         // whether the last timed semaphore wait timed out
+    uint8_t priority;      // 0 is highest, 255 is lowest; may be boosted
+    uint8_t basePriority;  // priority set by the user
+    uint8_t boostPriority; // priority when woken up by an ISR; 255 means no boost
+    int32_t *stackBase;    // lowest address of the stack, guarded by the MPU
+    uint32_t runCycles;    // clock cycles spent running, see OS_ThreadCyclesGet
+    uint32_t stackSize;    // number of 32-bit words in the stack
+    uint32_t windowCycles; // `runCycles` at the start of the idle window
+    uint8_t cpuPercent;    // CPU time in the last idle window, see OS_ThreadCpuPercentGet
+    Arena *arena;          // scratch memory of the thread, see OS_ThreadArenaSet
+} TCB;
+
+//
+// Define threads and semaphores at compile time.
+// TCBs, stacks, and semaphores are placed in the `.os_tcbs`, `.os_stacks`,
+//   and `.os_objects` sections, so their size shows up in the map file.
+// The stack is initialized as if the thread had already been running and
+//   then suspended (see OS_setInitialStack), so OS_Init only has to link
+//   the TCBs together.
+// With OS_CONFIG_STACK_GUARD, up to 15 words of the stack are taken by the
+//   MPU guard, see `mpu0.h`.
+// Thread and semaphore names are the names of the emitted variables:
+//
+// ```c
+// OS_THREAD_DEFINE(blinkThread, blink, 5, 64); // TCB blinkThread, int32_t blinkThreadStack[64]
+// OS_SEMAPHORE_DEFINE(dataReady, 0);           // int32_t dataReady
+// ```
+//
+#define OS_SECTION(sectionName) __attribute__((section(sectionName)))
+
+#define OS_STACK_FRAME_INIT(stackWords, fn)       \
+    [(stackWords) - 1] = 0x01000000,  /* PSR */  \
+    [(stackWords) - 2] = (int32_t)(fn), /* PC */ \
+    [(stackWords) - 3] = 0x14141414,  /* LR */   \
+    [(stackWords) - 4] = 0x12121212,  /* R12 */  \
+    [(stackWords) - 5] = 0x03030303,  /* R3 */   \
+    [(stackWords) - 6] = 0x02020202,  /* R2 */   \
+    [(stackWords) - 7] = 0x01010101,  /* R1 */   \
+    [(stackWords) - 8] = 0x00000000,  /* R0 */   \
+    [(stackWords) - 9] = 0x11111111,  /* R11 */  \
+    [(stackWords) - 10] = 0x10101010, /* R10 */  \
+    [(stackWords) - 11] = 0x09090909, /* R9 */   \
+    [(stackWords) - 12] = 0x08080808, /* R8 */   \
+    [(stackWords) - 13] = 0x07070707, /* R7 */   \
+    [(stackWords) - 14] = 0x06060606, /* R6 */   \
+    [(stackWords) - 15] = 0x05050505, /* R5 */   \
+    [(stackWords) - 16] = 0x04040404  /* R4 */
+
+#define OS_THREAD_DEFINE(threadName, fn, prio, stackWords)     \
+    OS_SECTION(".os_stacks")                                   \
+    int32_t threadName##Stack[stackWords] = {                  \
+        OS_STACK_FRAME_INIT(stackWords, fn)};                  \
+    OS_SECTION(".os_tcbs")                                     \
+    TCB threadName = {                                         \
+        .sp = &threadName##Stack[(stackWords) - 16],           \
+        .next = 0,                                             \
+        .name = #threadName,                                   \
+        .sleep = 0,                                            \
+        .status = TCBStateActive,                              \
+        .blocked = 0,                                          \
+        .timedOut = false,                                     \
+        .priority = (prio),                                    \
+        .basePriority = (prio),                                \
+        .boostPriority = 255,                                  \
+        .stackBase = threadName##Stack,                        \
+        .runCycles = 0,                                        \
+        .stackSize = (stackWords),                             \
+        .windowCycles = 0,                                     \
+        .cpuPercent = 0,                                       \
+        .arena = 0}
+
+#define OS_SEMAPHORE_DEFINE(semaphoreName, initialValue) \
+    OS_SECTION(".os_objects")                            \
+    int32_t semaphoreName = (initialValue)
+
+void OS_Init(
+    uint32_t schedulerFrequencyHz,
+    void (*firstTask)(void),
+    uint8_t priority,
+    const char *name);
+void OS_Launch(void);
+#if OS_CONFIG_THREAD_CREATE_KILL
+OS_Err OS_ThreadCreate(void (*task)(void), uint8_t priority, const char *name);
+OS_Err OS_ThreadKill(void);
+#endif
+TCB *OS_ThreadSelfGet(void);
+uint32_t OS_ThreadsGet(TCB **threads, uint32_t maxThreads);
+uint32_t OS_ThreadStackUnusedGet(TCB *thread);
+void OS_ThreadArenaSet(TCB *thread, Arena *arena);
+Arena *OS_ThreadArenaGet(void);
+#if OS_CONFIG_PRIORITY_SCHEDULER
+void OS_ThreadSetPriority(TCB *thread, uint8_t priority);
+void OS_ThreadSetBoost(TCB *thread, uint8_t boostPriority);
+#endif
+#if OS_CONFIG_CYCLES_ACCOUNTING
+uint32_t OS_ThreadCyclesGet(TCB *thread);
+#endif
+bool OS_IsInterruptContext(void);
+void OS_ThreadSuspend(void);
+#if OS_CONFIG_SLEEP
+void OS_ThreadSleep(uint32_t ms);
+void OS_ThreadSleepUntil(uint32_t *lastWakeTicks, uint32_t periodMs);
+uint32_t OS_TicksGet(void);
+#endif
+#if OS_CONFIG_SEMAPHORES
+void OS_SemaphoreWait(int32_t *s);
+#if OS_CONFIG_SLEEP
+OS_Err OS_SemaphoreWaitTimeout(int32_t *s, uint32_t timeoutMs);
+#endif
+bool OS_SemaphoreTryWait(int32_t *s);
+void OS_SemaphoreSignal(int32_t *s);
+bool OS_SemaphoreSignalFromISR(int32_t *s);
+uint32_t OS_ISRSwitchesPendedGet(void);
+uint32_t OS_ISRSwitchesSavedGet(void);
+#endif
+#if OS_IDLE_THREAD
+void OS_SetIdleHook(void (*hook)(void));
+#endif
+#if OS_CONFIG_SLEEP && OS_CONFIG_CYCLES_ACCOUNTING
+uint32_t OS_GetIdlePercent(void);
+uint32_t OS_ThreadCpuPercentGet(TCB *thread);
+#endif
+
+#endif
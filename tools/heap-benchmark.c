@@ -0,0 +1,247 @@
+//*****************************************************************************
+//
+// Host benchmark of the heap managers of project 30: the fixed-size blocks
+//   of `heap-blocks.c`, the size classes of `heap-classes.c`, the TLSF heap
+//   of `heap-tlsf.c` and the buddy heap of `heap-buddy.c`.
+//
+//     gcc -std=gnu11 -O2 -Itools/host -Iprojects/30_malloc_free -o heap-benchmark tools/heap-benchmark.c projects/30_malloc_free/heap-*.c
+//     ./heap-benchmark [operations] [seed]
+//
+// Every heap runs the same random sequences of allocations and releases,
+//   over a heap of `HEAP_SIZE` bytes, like the `.sysmem` section set with
+//   `--heap_size` in the CCS project. Each sequence follows a trace of the
+//   sizes and lifetimes the projects actually use:
+//
+//   shell      command lines and their tokens, 4 to 32 bytes, few at once
+//   telemetry  frames of 48 to 128 bytes, queued up to 16 at once
+//   dma        power-of-two buffers from 64 to 512 bytes, few at once
+//   mixed      all of the above, interleaved
+//
+// A heap only runs the traces whose blocks it can serve: the fixed-size
+//   heap only runs `shell`, for instance.
+//
+// Each operation is timed on its own, so that the worst case shows up:
+//   the maximum includes the noise of the host (interrupts, preemption),
+//   so it's best read as an upper bound, and compared between heaps run
+//   back to back; the 99th percentile is steadier. The output has one line
+//   per heap, trace and operation:
+//
+//     bench,<heap>_<trace>_<alloc|free>,<count>,<mean ns>,<p99 ns>,<max ns>,<failed>,<Mops/s>
+//
+//*****************************************************************************
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "heap-blocks.h"
+#include "heap-buddy.h"
+#include "heap-classes.h"
+#include "heap-tlsf.h"
+
+#define HEAP_SIZE 8192
+#define MAXLIVE 16
+#define HISTOGRAM_NS 4096 // latencies above go in the last bucket
+
+typedef struct Heap
+{
+    const char *name;
+    void (*init)(void *heapStart, uint32_t heapSize);
+    void *(*alloc)(uint32_t size);
+    void (*release)(void *pt);
+    uint32_t maxSize; // biggest block it can serve
+} Heap;
+
+//
+// A trace allocates blocks of `minSize` to `maxSize` bytes, rounded up to a
+//   power of two if `isPow2`, with up to `maxLive` blocks allocated at once.
+//   The traces with `isMixed` pick one of the others for each allocation.
+//
+typedef struct Trace
+{
+    const char *name;
+    uint32_t minSize;
+    uint32_t maxSize;
+    bool isPow2;
+    uint32_t maxLive;
+    bool isMixed;
+} Trace;
+
+typedef struct Stats
+{
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+    uint64_t failed;
+    uint32_t histogram[HISTOGRAM_NS + 1];
+} Stats;
+
+static uint64_t heap[HEAP_SIZE / sizeof(uint64_t)];
+
+static void *blocksAlloc(uint32_t size);
+
+static const Heap heaps[] = {
+    {"blocks", Heap_Init, blocksAlloc, Heap_Release, HEAP_BLOCKSIZE},
+    {"classes", Heap_ClassesInit, Heap_Alloc, Heap_Free, 256},
+    {"tlsf", Tlsf_Init, Tlsf_Alloc, Tlsf_Free, 1024},
+    {"buddy", Buddy_Init, Buddy_Alloc, Buddy_Free, 1 << BUDDY_MAX_LOG2},
+};
+
+static const Trace traces[] = {
+    {"shell", 4, 32, false, 4, false},
+    {"telemetry", 48, 128, false, 16, false},
+    {"dma", 64, 512, true, 6, false},
+    {"mixed", 4, 512, false, 16, true},
+};
+#define NUMTRACES (sizeof(traces) / sizeof(traces[0]))
+
+//
+// The fn run applies the random sequence of `trace` to `heapUT`.
+//
+static void run(const Heap *heapUT, const Trace *trace, uint32_t operations, uint32_t seed);
+
+//
+// The fn sizeNext returns the size of the next block of `trace`.
+//
+static uint32_t sizeNext(const Trace *trace);
+
+static uint64_t nowNs(void);
+static void statsPush(Stats *stats, uint64_t ns, bool hasFailed);
+
+//
+// The fn statsPrint prints a line of results; `mops` is the throughput of
+//   the whole run, in millions of allocations and releases per second,
+//   timing included, so it's the same on the two lines of a run.
+//
+static void statsPrint(const char *heapName, const char *traceName, const char *op, Stats *stats, double mops);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+int main(int argc, char **argv)
+{
+    uint32_t operations = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+    uint32_t seed = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1;
+
+    for (uint32_t heapIdx = 0; heapIdx < sizeof(heaps) / sizeof(heaps[0]); heapIdx++)
+    {
+        for (uint32_t traceIdx = 0; traceIdx < NUMTRACES; traceIdx++)
+        {
+            if (traces[traceIdx].maxSize <= heaps[heapIdx].maxSize)
+            {
+                run(&heaps[heapIdx], &traces[traceIdx], operations, seed);
+            }
+        }
+    }
+    return 0;
+}
+
+static void run(const Heap *heapUT, const Trace *trace, uint32_t operations, uint32_t seed)
+{
+    static Stats allocStats, freeStats;
+    allocStats = (Stats){0};
+    freeStats = (Stats){0};
+
+    void *live[MAXLIVE] = {0};
+    heapUT->init(heap, HEAP_SIZE);
+    srand(seed);
+    uint64_t start = nowNs();
+    for (uint32_t op = 0; op < operations; op++)
+    {
+        uint32_t slot = rand() % trace->maxLive;
+        if (live[slot] == NULL)
+        {
+            uint32_t size = sizeNext(trace);
+            uint64_t opStart = nowNs();
+            live[slot] = heapUT->alloc(size);
+            statsPush(&allocStats, nowNs() - opStart, live[slot] == NULL);
+        }
+        else
+        {
+            uint64_t opStart = nowNs();
+            heapUT->release(live[slot]);
+            statsPush(&freeStats, nowNs() - opStart, false);
+            live[slot] = NULL;
+        }
+    }
+    double mops = (1000.0 * operations) / (nowNs() - start);
+
+    for (uint32_t slot = 0; slot < MAXLIVE; slot++)
+    {
+        heapUT->release(live[slot]);
+    }
+    statsPrint(heapUT->name, trace->name, "alloc", &allocStats, mops);
+    statsPrint(heapUT->name, trace->name, "free", &freeStats, mops);
+}
+
+static uint32_t sizeNext(const Trace *trace)
+{
+    if (trace->isMixed)
+    {
+        return sizeNext(&traces[rand() % (NUMTRACES - 1)]);
+    }
+
+    uint32_t size = trace->minSize + (rand() % (trace->maxSize - trace->minSize + 1));
+    if (trace->isPow2)
+    {
+        uint32_t pow2 = trace->minSize;
+        while (pow2 < size)
+        {
+            pow2 <<= 1;
+        }
+        size = pow2;
+    }
+    return size;
+}
+
+static void *blocksAlloc(uint32_t size)
+{
+    (void)size; // never above HEAP_BLOCKSIZE, the `maxSize` of the heap
+    return Heap_Allocate();
+}
+
+static uint64_t nowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+static void statsPush(Stats *stats, uint64_t ns, bool hasFailed)
+{
+    stats->count++;
+    stats->totalNs += ns;
+    if (ns > stats->maxNs)
+    {
+        stats->maxNs = ns;
+    }
+    stats->histogram[(ns < HISTOGRAM_NS) ? ns : HISTOGRAM_NS]++;
+    if (hasFailed)
+    {
+        stats->failed++;
+    }
+}
+
+static void statsPrint(const char *heapName, const char *traceName, const char *op, Stats *stats, double mops)
+{
+    double meanNs = stats->count ? (double)stats->totalNs / stats->count : 0;
+
+    uint64_t p99Ns = 0;
+    uint64_t below = 0;
+    while ((p99Ns < HISTOGRAM_NS) && (below + stats->histogram[p99Ns] < (stats->count * 99) / 100))
+    {
+        below += stats->histogram[p99Ns];
+        p99Ns++;
+    }
+
+    printf("bench,%s_%s_%s,%llu,%.1f,%llu,%llu,%llu,%.2f\n", heapName, traceName, op,
+           (unsigned long long)stats->count, meanNs, (unsigned long long)p99Ns,
+           (unsigned long long)stats->maxNs, (unsigned long long)stats->failed,
+           mops);
+}
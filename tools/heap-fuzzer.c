@@ -0,0 +1,304 @@
+//*****************************************************************************
+//
+// Host fuzzer of the heap managers of project 30, to validate a change to
+//   an allocator without the board:
+//
+//     gcc -std=gnu11 -O1 -g -fsanitize=address,undefined -Itools/host -Iprojects/30_malloc_free -o heap-fuzzer tools/heap-fuzzer.c projects/30_malloc_free/heap-*.c
+//     ./heap-fuzzer [operations] [seed]
+//
+// Each heap gets a random sequence of allocations and releases, of random
+//   sizes up to the biggest block it can serve, with up to `MAXLIVE` blocks
+//   allocated at once. After every operation, the fuzzer checks that:
+// - each block is inside the heap, and aligned to 8 bytes, or to its size
+//   rounded up to a power of two for the buddy heap;
+// - no two live blocks overlap, using a shadow map of the heap;
+// - the content of a block is unchanged when it's released, so the heap
+//   manager never wrote into an allocated block.
+// At the end, every block is released, and the counters of the heap must
+//   show it empty again: no block used, and as many free bytes as right
+//   after the init, that is, all the free blocks merged back.
+// For the fixed-size heap, double and foreign releases must be rejected
+//   and counted, leaving the heap usable.
+//
+// The output has one line per heap:
+//
+//     fuzz,<heap>,<operations>,<allocations>,<failed>,<ok|error>
+//
+// followed by the first broken invariant, if any. The exit code is 0 when
+//   all heaps are ok.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heap-blocks.h"
+#include "heap-buddy.h"
+#include "heap-classes.h"
+#include "heap-tlsf.h"
+
+#define HEAP_SIZE 8192
+#define MAXLIVE 64
+
+//
+// A heap manager under test: `maxSize` is the biggest block it can serve,
+//   and `freeBytesGet` tells how many bytes are free, to check that they
+//   are all back at the end.
+//
+typedef struct HeapUnderTest
+{
+    const char *name;
+    void (*init)(void *heapStart, uint32_t heapSize);
+    void *(*alloc)(uint32_t size);
+    void (*release)(void *pt);
+    uint32_t (*freeBytesGet)(void);
+    uint32_t maxSize;
+    bool isNaturallyAligned;
+} HeapUnderTest;
+
+typedef struct Block
+{
+    uint8_t *pt;
+    uint32_t size;
+    uint8_t pattern;
+} Block;
+
+static uint64_t heap[HEAP_SIZE / sizeof(uint64_t)];
+static uint8_t shadow[HEAP_SIZE]; // live slot + 1 owning each byte, 0 if none
+static const char *error;
+
+static void *blocksAlloc(uint32_t size);
+static uint32_t blocksFreeBytesGet(void);
+static uint32_t classesFreeBytesGet(void);
+static uint32_t buddyFreeBytesGet(void);
+
+static const HeapUnderTest heaps[] = {
+    {"blocks", Heap_Init, blocksAlloc, Heap_Release, blocksFreeBytesGet, HEAP_BLOCKSIZE, false},
+    {"classes", Heap_ClassesInit, Heap_Alloc, Heap_Free, classesFreeBytesGet, 256, false},
+    {"tlsf", Tlsf_Init, Tlsf_Alloc, Tlsf_Free, Tlsf_FreeBytesGet, 1024, false},
+    {"buddy", Buddy_Init, Buddy_Alloc, Buddy_Free, buddyFreeBytesGet, 1 << BUDDY_MAX_LOG2, true},
+};
+
+//
+// The fn fuzz runs `operations` random operations on `heapUT`, and returns
+//   false as soon as an invariant is broken, with the reason in `error`.
+//
+static bool fuzz(const HeapUnderTest *heapUT, uint32_t operations, uint32_t *allocations, uint32_t *failed);
+
+//
+// The fn blockCheck checks a block just allocated, and marks it as owned
+//   by `slot` in the shadow map.
+// The fn blockRelease checks that the content of the block is unchanged,
+//   clears it from the shadow map, and releases it.
+//
+static bool blockCheck(const HeapUnderTest *heapUT, Block *block, uint32_t slot);
+static void blockRelease(const HeapUnderTest *heapUT, Block *block);
+
+//
+// The fn misuseCheck releases blocks of the fixed-size heap twice, and
+//   pointers that aren't blocks, and checks that they're all rejected.
+//
+static bool misuseCheck(void);
+
+static uint32_t roundUpPow2(uint32_t size);
+
+//*****************************************************************************
+//
+//       IMPLEMENTATION
+//
+//*****************************************************************************
+
+int main(int argc, char **argv)
+{
+    uint32_t operations = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+    uint32_t seed = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1;
+
+    bool isOk = true;
+    for (uint32_t idx = 0; idx < sizeof(heaps) / sizeof(heaps[0]); idx++)
+    {
+        uint32_t allocations = 0, failed = 0;
+        srand(seed);
+        error = NULL;
+        bool isHeapOk = fuzz(&heaps[idx], operations, &allocations, &failed);
+        if (isHeapOk && (heaps[idx].init == Heap_Init))
+        {
+            isHeapOk = misuseCheck();
+        }
+        printf("fuzz,%s,%u,%u,%u,%s\n", heaps[idx].name, operations, allocations, failed,
+               isHeapOk ? "ok" : "error");
+        if (!isHeapOk)
+        {
+            printf("  %s\n", error);
+            isOk = false;
+        }
+    }
+    return isOk ? 0 : 1;
+}
+
+static bool fuzz(const HeapUnderTest *heapUT, uint32_t operations, uint32_t *allocations, uint32_t *failed)
+{
+    Block live[MAXLIVE] = {0};
+    memset(shadow, 0, sizeof(shadow));
+    heapUT->init(heap, HEAP_SIZE);
+    uint32_t initialFreeBytes = heapUT->freeBytesGet();
+
+    for (uint32_t op = 0; op < operations; op++)
+    {
+        uint32_t slot = rand() % MAXLIVE;
+        Block *block = &live[slot];
+        if (block->pt != NULL)
+        {
+            blockRelease(heapUT, block);
+            if (error != NULL)
+                return false;
+            continue;
+        }
+
+        // mostly small blocks, as in the projects, with a few big ones
+        uint32_t maxSize = (rand() % 4) ? (heapUT->maxSize / 4) : heapUT->maxSize;
+        block->size = 1 + (rand() % maxSize);
+        block->pt = heapUT->alloc(block->size);
+        if (block->pt == NULL)
+        {
+            (*failed)++;
+            continue;
+        }
+        (*allocations)++;
+        if (!blockCheck(heapUT, block, slot))
+            return false;
+    }
+
+    for (uint32_t slot = 0; slot < MAXLIVE; slot++)
+    {
+        if (live[slot].pt != NULL)
+        {
+            blockRelease(heapUT, &live[slot]);
+            if (error != NULL)
+                return false;
+        }
+    }
+    if (heapUT->freeBytesGet() != initialFreeBytes)
+    {
+        error = "free bytes not back to their initial value once all blocks are released";
+        return false;
+    }
+    return true;
+}
+
+static bool blockCheck(const HeapUnderTest *heapUT, Block *block, uint32_t slot)
+{
+    uint8_t *heapStart = (uint8_t *)heap;
+    if ((block->pt < heapStart) || (block->pt + block->size > heapStart + HEAP_SIZE))
+    {
+        error = "block outside the heap";
+        return false;
+    }
+    uint32_t alignment = heapUT->isNaturallyAligned ? roundUpPow2(block->size) : 8;
+    if (((uintptr_t)block->pt % alignment) != 0)
+    {
+        error = "block not aligned";
+        return false;
+    }
+
+    uint32_t offset = block->pt - heapStart;
+    for (uint32_t idx = 0; idx < block->size; idx++)
+    {
+        if (shadow[offset + idx] != 0)
+        {
+            error = "block overlapping a live block";
+            return false;
+        }
+        shadow[offset + idx] = slot + 1;
+    }
+    block->pattern = rand();
+    memset(block->pt, block->pattern, block->size);
+    return true;
+}
+
+static void blockRelease(const HeapUnderTest *heapUT, Block *block)
+{
+    uint32_t offset = block->pt - (uint8_t *)heap;
+    for (uint32_t idx = 0; idx < block->size; idx++)
+    {
+        if (block->pt[idx] != block->pattern)
+        {
+            error = "block overwritten while allocated";
+        }
+        shadow[offset + idx] = 0;
+    }
+    heapUT->release(block->pt);
+    block->pt = NULL;
+}
+
+static bool misuseCheck(void)
+{
+    Heap_Init(heap, HEAP_SIZE);
+    uint8_t *blockA = Heap_Allocate();
+    uint8_t *blockB = Heap_Allocate();
+    Heap_Release(blockA);
+    Heap_Release(blockA);     // double
+    Heap_Release(blockB + 4); // not the start of a block
+    Heap_Release(shadow);     // not in the heap
+
+    Heap_Stats stats;
+    Heap_StatsGet(&stats);
+    if ((stats.doubleReleases != 1) || (stats.foreignReleases != 2) || (stats.used != 1))
+    {
+        error = "bad releases not counted";
+        return false;
+    }
+
+    // the double release mustn't have put blockA twice in the free list
+    uint8_t *blockC = Heap_Allocate();
+    uint8_t *blockD = Heap_Allocate();
+    if ((blockC == blockD) || (blockC == blockB) || (blockD == blockB))
+    {
+        error = "same block allocated twice after a double release";
+        return false;
+    }
+    return true;
+}
+
+static void *blocksAlloc(uint32_t size)
+{
+    (void)size; // never above HEAP_BLOCKSIZE, the `maxSize` of the heap
+    return Heap_Allocate();
+}
+
+static uint32_t blocksFreeBytesGet(void)
+{
+    Heap_Stats stats;
+    Heap_StatsGet(&stats);
+    return (HEAP_SIZE / HEAP_BLOCKSIZE - stats.used) * HEAP_BLOCKSIZE;
+}
+
+static uint32_t classesFreeBytesGet(void)
+{
+    uint32_t freeBytes = 0;
+    for (uint32_t idx = 0; idx < HEAP_NUMCLASSES; idx++)
+    {
+        Heap_ClassStats stats;
+        Heap_ClassStatsGet(idx, &stats);
+        freeBytes += (stats.capacity - stats.used) * stats.blockSize;
+    }
+    return freeBytes;
+}
+
+static uint32_t buddyFreeBytesGet(void)
+{
+    Buddy_Stats stats;
+    Buddy_StatsGet(&stats);
+    return stats.freeBytes;
+}
+
+static uint32_t roundUpPow2(uint32_t size)
+{
+    uint32_t pow2 = 1;
+    while (pow2 < size)
+    {
+        pow2 <<= 1;
+    }
+    return pow2;
+}
@@ -0,0 +1,16 @@
+//*****************************************************************************
+//
+// Stand-in for TivaWare's `driverlib/debug.h`, to build hardware-independent
+//   modules on the host with the tools in `tools/`: ASSERT aborts the
+//   program, like `__error__` halts the board in debug builds.
+//
+//*****************************************************************************
+
+#ifndef _HOST_DEBUG_H_
+#define _HOST_DEBUG_H_
+
+#include <assert.h>
+
+#define ASSERT(expr) assert(expr)
+
+#endif
@@ -0,0 +1,16 @@
+//*****************************************************************************
+//
+// Stand-in for TivaWare's `utils/uartstdio.h`, to build hardware-independent
+//   modules on the host with the tools in `tools/`: UARTprintf prints to
+//   the standard output.
+//
+//*****************************************************************************
+
+#ifndef _HOST_UARTSTDIO_H_
+#define _HOST_UARTSTDIO_H_
+
+int printf(const char *format, ...);
+
+#define UARTprintf printf
+
+#endif
@@ -0,0 +1,626 @@
+//*****************************************************************************
+//
+// Offline schedulability analysis of a thread set for the RTOS in `rtos/`,
+//   configured with the priority scheduler, to be run on the host before
+//   flashing the board:
+//
+//     gcc -std=c99 -O2 -o schedulability tools/schedulability.c -lm
+//     ./schedulability threadset.txt [serial.log]
+//
+// The thread set file declares one item per line; `#` starts a comment:
+//
+//     clock <Hz>           CPU clock, 16000000 if omitted
+//     threadfreq <Hz>      SysTick frequency (THREADFREQ), 1000 if omitted
+//     switch <cycles>      cost of a context switch, 0 if omitted
+//     thread <name> <period ms|-> <deadline ms> <priority> <wcet cycles|-> [<resource>:<cycles> ...]
+//
+// A period of `-` declares a background thread, always ready to run, like
+//   `userTask0` in project 29; its deadline is ignored.
+// Each `<resource>:<cycles>` is the longest critical section of the thread
+//   on a semaphore used as a mutex, taken at most once per job.
+//
+// The optional serial log is what the board printed over UART: lines in the
+//   form `wcet,<name>,<cycles>,<jobs>` (see `wcet-probe.h`) replace the WCET
+//   declared for `<name>`, and lines in the form `bench,switch_*,...` (see
+//   `kernel-benchmark.h`) replace the switch cost with the largest max.
+//
+// Fixed-priority analysis is the policy the kernel actually runs:
+// - threads with the same priority are round-robin, so they interfere with
+//   each other like higher priority ones do;
+// - each job pays two context switches, and each SysTick pays one more;
+// - a thread woken up by Timer0 or by an ISR waits up to one SysTick for
+//   the scheduler to run, which is accounted as release jitter;
+// - the kernel has no priority inheritance, so when a thread is blocked by a
+//   lower priority one, the threads with priority in between can preempt the
+//   holder and are counted as interfering too.
+//
+// EDF analysis (processor demand, with SRP blocking) tells whether the same
+//   thread set would fit with deadline-driven scheduling, for comparison.
+//
+// The exit code is 0 when the thread set is schedulable with fixed
+//   priorities, 1 when it isn't (or can't be told), and 2 on bad input.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MAXTHREADS 32
+#define MAXRESOURCES 8
+#define MAXNAMELEN 32
+#define EDFMAXCHECKPOINTS 10000000
+
+typedef struct Resource
+{
+    char name[MAXNAMELEN];
+    uint64_t cycles; // longest critical section
+} Resource;
+
+typedef struct Thread
+{
+    char name[MAXNAMELEN];
+    bool background;  // always ready, no period nor deadline
+    uint64_t period;  // in cycles
+    uint64_t deadline;
+    unsigned priority; // 0 is the highest
+    uint64_t wcet;     // in cycles, 0 if unknown
+    bool wcetMeasured;
+    Resource resources[MAXRESOURCES];
+    unsigned numResources;
+} Thread;
+
+static Thread threads[MAXTHREADS];
+static unsigned numThreads = 0;
+static double clockHz = 16000000;
+static double threadFreq = 1000;
+static uint64_t switchCycles = 0;
+static bool switchMeasured = false;
+
+//
+// The fn parseThreadSet reads the thread set file; it returns false and
+//   prints the offending line on bad input.
+//
+static bool parseThreadSet(const char *path);
+
+//
+// The fn parseSerialLog reads the measurements printed by the board.
+//
+static bool parseSerialLog(const char *path);
+
+//
+// The fn msToCycles converts a time in ms as written in the thread set file.
+//
+static bool msToCycles(const char *text, uint64_t *cycles);
+
+//
+// The fn findThread returns the thread named `name`, or null.
+//
+static Thread *findThread(const char *name);
+
+//
+// The fn criticalSection returns the longest critical section of `thread`
+//   on the resource named `name`, or 0 if it doesn't use it.
+//
+static uint64_t criticalSection(const Thread *thread, const char *name);
+
+//
+// The fn cost returns the cycles a job of `thread` keeps the CPU busy,
+//   switches included.
+//
+static uint64_t cost(const Thread *thread);
+
+//
+// The fn fixedPriorityResponse runs the response-time analysis for thread
+//   `idx`: it returns false if the worst-case response exceeds the deadline,
+//   and writes the response and blocking found so far anyway.
+//
+static bool fixedPriorityResponse(unsigned idx, uint64_t *response, uint64_t *blocking);
+
+//
+// The fn edfSchedulable runs the processor demand test for the periodic
+//   threads; `verdict` is set to a short explanation.
+//
+static bool edfSchedulable(const char **verdict);
+
+//
+// The fn ceilDiv returns `a / b` rounded up.
+//
+static uint64_t ceilDiv(uint64_t a, uint64_t b);
+
+//
+// The fn cyclesToMs converts cycles back to ms for printing.
+//
+static double cyclesToMs(uint64_t cycles);
+
+//*****************************************************************************
+//
+//      IMPLEMENTATION
+//
+//*****************************************************************************
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: %s threadset.txt [serial.log]\n", argv[0]);
+        return 2;
+    }
+    if (!parseThreadSet(argv[1]) || (argc == 3 && !parseSerialLog(argv[2])))
+    {
+        return 2;
+    }
+
+    printf("clock %.0f Hz, SysTick %.0f Hz, context switch %llu cycles (%s)\n\n",
+           clockHz, threadFreq, (unsigned long long)switchCycles, switchMeasured ? "measured" : "declared");
+
+    double utilization = 0;
+    for (unsigned idx = 0; idx < numThreads; idx++)
+    {
+        if (!threads[idx].background)
+        {
+            utilization += (double)cost(&threads[idx]) / (double)threads[idx].period;
+        }
+    }
+    utilization += (double)switchCycles * threadFreq / clockHz;
+
+    printf("Fixed priority (the kernel's policy)\n");
+    printf("%-30s %4s %10s %10s %10s %10s %10s %10s  %s\n",
+           "thread", "prio", "period", "deadline", "wcet", "blocking", "response", "slack", "result");
+    bool fixedPriorityOk = true;
+    for (unsigned idx = 0; idx < numThreads; idx++)
+    {
+        Thread *thread = &threads[idx];
+        if (thread->background)
+        {
+            printf("%-30s %4u %10s %10s %10s %10s %10s %10s  background\n",
+                   thread->name, thread->priority, "-", "-", "-", "-", "-", "-");
+            continue;
+        }
+
+        uint64_t response = 0;
+        uint64_t blocking = 0;
+        bool ok = fixedPriorityResponse(idx, &response, &blocking);
+        fixedPriorityOk = fixedPriorityOk && ok;
+
+        char wcetText[16] = "?";
+        if (thread->wcet)
+        {
+            snprintf(wcetText, sizeof(wcetText), "%.3f%s", cyclesToMs(thread->wcet), thread->wcetMeasured ? "*" : "");
+        }
+        char responseText[16] = "?";
+        char slackText[16] = "-";
+        if (response)
+        {
+            snprintf(responseText, sizeof(responseText), ok ? "%.3f" : ">%.3f", cyclesToMs(response));
+        }
+        if (ok)
+        {
+            snprintf(slackText, sizeof(slackText), "%.3f", cyclesToMs(thread->deadline - response));
+        }
+        printf("%-30s %4u %10.3f %10.3f %10s %10.3f %10s %10s  %s\n",
+               thread->name, thread->priority, cyclesToMs(thread->period), cyclesToMs(thread->deadline),
+               wcetText, cyclesToMs(blocking), responseText, slackText,
+               ok ? "ok" : (thread->wcet ? "MISSES DEADLINE" : "NO WCET"));
+    }
+    printf("(times in ms, * = measured on target)\n\n");
+
+    const char *verdict;
+    bool edfOk = edfSchedulable(&verdict);
+    printf("EDF (for comparison): %s, %s\n", edfOk ? "schedulable" : "NOT schedulable", verdict);
+    printf("Utilization of periodic threads and SysTick: %.1f%%\n\n", utilization * 100);
+
+    printf("%s\n", fixedPriorityOk ? "SCHEDULABLE" : "NOT SCHEDULABLE");
+    return fixedPriorityOk ? 0 : 1;
+}
+
+static bool parseThreadSet(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+
+    char line[512];
+    unsigned lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        lineNumber++;
+        char *comment = strchr(line, '#');
+        if (comment)
+        {
+            *comment = '\0';
+        }
+
+        char *keyword = strtok(line, " \t\r\n");
+        if (!keyword)
+        {
+            continue;
+        }
+
+        char *argument = strtok(NULL, " \t\r\n");
+        if (strcmp(keyword, "clock") == 0 && argument)
+        {
+            clockHz = strtod(argument, NULL);
+            ok = clockHz > 0;
+        }
+        else if (strcmp(keyword, "threadfreq") == 0 && argument)
+        {
+            threadFreq = strtod(argument, NULL);
+            ok = threadFreq > 0;
+        }
+        else if (strcmp(keyword, "switch") == 0 && argument)
+        {
+            switchCycles = strtoull(argument, NULL, 10);
+        }
+        else if (strcmp(keyword, "thread") == 0 && argument && numThreads < MAXTHREADS)
+        {
+            Thread *thread = &threads[numThreads++];
+            memset(thread, 0, sizeof(*thread));
+            snprintf(thread->name, sizeof(thread->name), "%s", argument);
+
+            char *period = strtok(NULL, " \t\r\n");
+            char *deadline = strtok(NULL, " \t\r\n");
+            char *priority = strtok(NULL, " \t\r\n");
+            char *wcet = strtok(NULL, " \t\r\n");
+            ok = period && deadline && priority && wcet;
+            if (ok)
+            {
+                thread->background = strcmp(period, "-") == 0;
+                ok = thread->background ||
+                     (msToCycles(period, &thread->period) && msToCycles(deadline, &thread->deadline));
+                thread->priority = (unsigned)strtoul(priority, NULL, 10);
+                thread->wcet = strcmp(wcet, "-") == 0 ? 0 : strtoull(wcet, NULL, 10);
+            }
+
+            char *resource;
+            while (ok && (resource = strtok(NULL, " \t\r\n")))
+            {
+                char *colon = strchr(resource, ':');
+                ok = colon && thread->numResources < MAXRESOURCES;
+                if (ok)
+                {
+                    *colon = '\0';
+                    Resource *entry = &thread->resources[thread->numResources++];
+                    snprintf(entry->name, sizeof(entry->name), "%s", resource);
+                    entry->cycles = strtoull(colon + 1, NULL, 10);
+                }
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    if (!ok)
+    {
+        fprintf(stderr, "%s:%u: invalid line\n", path, lineNumber);
+    }
+    return ok;
+}
+
+static bool parseSerialLog(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[MAXNAMELEN];
+        unsigned long long cycles;
+        unsigned long long min, avg, max, count;
+        if (sscanf(line, " wcet,%31[^,],%llu", name, &cycles) == 2)
+        {
+            Thread *thread = findThread(name);
+            if (thread)
+            {
+                thread->wcet = cycles;
+                thread->wcetMeasured = true;
+            }
+            else
+            {
+                fprintf(stderr, "%s: no thread named %s, ignored\n", path, name);
+            }
+        }
+        else if (sscanf(line, " bench,%31[^,],%llu,%llu,%llu,%llu", name, &min, &avg, &max, &count) == 5 &&
+                 strncmp(name, "switch_", strlen("switch_")) == 0)
+        {
+            if (!switchMeasured || max > switchCycles)
+            {
+                switchCycles = max;
+            }
+            switchMeasured = true;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+static bool msToCycles(const char *text, uint64_t *cycles)
+{
+    char *end;
+    double ms = strtod(text, &end);
+    *cycles = (uint64_t)llround(ms * clockHz / 1000);
+    return *end == '\0' && *cycles > 0;
+}
+
+static Thread *findThread(const char *name)
+{
+    for (unsigned idx = 0; idx < numThreads; idx++)
+    {
+        if (strcmp(threads[idx].name, name) == 0)
+        {
+            return &threads[idx];
+        }
+    }
+    return 0;
+}
+
+static uint64_t criticalSection(const Thread *thread, const char *name)
+{
+    for (unsigned idx = 0; idx < thread->numResources; idx++)
+    {
+        if (strcmp(thread->resources[idx].name, name) == 0)
+        {
+            return thread->resources[idx].cycles;
+        }
+    }
+    return 0;
+}
+
+static uint64_t cost(const Thread *thread)
+{
+    return thread->wcet + 2 * switchCycles;
+}
+
+static bool fixedPriorityResponse(unsigned idx, uint64_t *response, uint64_t *blocking)
+{
+    const Thread *self = &threads[idx];
+    uint64_t tick = (uint64_t)llround(clockHz / threadFreq);
+    bool interferes[MAXTHREADS] = {false};
+    unsigned roundRobinPeers = 0;
+    bool known = self->wcet != 0;
+
+    // direct blocking: once per resource, by the lower priority thread with
+    //   the longest critical section on it
+    *blocking = 0;
+    unsigned lowestBlocker = self->priority;
+    for (unsigned res = 0; res < self->numResources; res++)
+    {
+        uint64_t longest = 0;
+        for (unsigned other = 0; other < numThreads; other++)
+        {
+            uint64_t cycles = criticalSection(&threads[other], self->resources[res].name);
+            if (threads[other].priority > self->priority && cycles)
+            {
+                longest = cycles > longest ? cycles : longest;
+                lowestBlocker = threads[other].priority > lowestBlocker ? threads[other].priority : lowestBlocker;
+            }
+        }
+        *blocking += longest;
+    }
+
+    for (unsigned other = 0; other < numThreads; other++)
+    {
+        const Thread *thread = &threads[other];
+        if (other == idx)
+        {
+            continue;
+        }
+        if (thread->background)
+        {
+            if (thread->priority < self->priority)
+            {
+                // starves `self` for good
+                *response = 0;
+                return false;
+            }
+            roundRobinPeers += thread->priority == self->priority;
+            continue;
+        }
+        // higher and same priority threads, and those that preempt a lower
+        //   priority thread holding a semaphore `self` is waiting for
+        interferes[other] = thread->priority <= self->priority || thread->priority < lowestBlocker;
+        known = known && (!interferes[other] || thread->wcet != 0);
+    }
+    if (!known)
+    {
+        *response = 0;
+        return false;
+    }
+
+    // a busy thread with the same priority takes a whole time-slice for
+    //   every time-slice, even partial, `self` runs
+    uint64_t own = cost(self);
+    own += roundRobinPeers * ceilDiv(own, tick) * tick;
+
+    uint64_t jitter = tick;
+    uint64_t busy = own + *blocking;
+    while (1)
+    {
+        uint64_t next = own + *blocking + ceilDiv(busy, tick) * switchCycles;
+        for (unsigned other = 0; other < numThreads; other++)
+        {
+            if (interferes[other])
+            {
+                next += ceilDiv(busy + jitter, threads[other].period) * cost(&threads[other]);
+            }
+        }
+
+        *response = next + jitter;
+        if (*response > self->deadline)
+        {
+            return false;
+        }
+        if (next == busy)
+        {
+            return true;
+        }
+        busy = next;
+    }
+}
+
+static bool edfSchedulable(const char **verdict)
+{
+    uint64_t tick = (uint64_t)llround(clockHz / threadFreq);
+    double utilization = (double)switchCycles / (double)tick;
+    double laxity = 0;
+    uint64_t longestDeadline = 0;
+    uint64_t hyperperiod = 1;
+    bool hyperperiodValid = true;
+    uint64_t maxBlocking = 0;
+    for (unsigned idx = 0; idx < numThreads; idx++)
+    {
+        const Thread *thread = &threads[idx];
+        if (thread->background)
+        {
+            continue;
+        }
+        if (!thread->wcet)
+        {
+            *verdict = "unknown WCET";
+            return false;
+        }
+
+        double share = (double)cost(thread) / (double)thread->period;
+        utilization += share;
+        if (thread->period > thread->deadline)
+        {
+            laxity += (double)(thread->period - thread->deadline) * share;
+        }
+        longestDeadline = thread->deadline > longestDeadline ? thread->deadline : longestDeadline;
+
+        uint64_t a = hyperperiod;
+        uint64_t b = thread->period;
+        while (b)
+        {
+            uint64_t r = a % b;
+            a = b;
+            b = r;
+        }
+        if (hyperperiod / a > UINT64_MAX / thread->period)
+        {
+            hyperperiodValid = false;
+        }
+        else
+        {
+            hyperperiod = hyperperiod / a * thread->period;
+        }
+
+        for (unsigned res = 0; res < thread->numResources; res++)
+        {
+            maxBlocking = thread->resources[res].cycles > maxBlocking ? thread->resources[res].cycles : maxBlocking;
+        }
+    }
+
+    if (utilization > 1)
+    {
+        *verdict = "utilization above 100%";
+        return false;
+    }
+
+    // the demand can exceed the time available only before this bound
+    uint64_t bound = UINT64_MAX;
+    if (utilization < 1)
+    {
+        bound = (uint64_t)((laxity + (double)maxBlocking) / (1 - utilization)) + 1;
+        bound = bound > longestDeadline ? bound : longestDeadline;
+    }
+    if (hyperperiodValid && hyperperiod <= UINT64_MAX - longestDeadline)
+    {
+        bound = hyperperiod + longestDeadline < bound ? hyperperiod + longestDeadline : bound;
+    }
+    if (bound == UINT64_MAX)
+    {
+        *verdict = "no bound on the busy period";
+        return false;
+    }
+
+    // check the demand at every absolute deadline up to the bound
+    unsigned long checkpoints = 0;
+    for (unsigned idx = 0; idx < numThreads; idx++)
+    {
+        const Thread *thread = &threads[idx];
+        if (thread->background)
+        {
+            continue;
+        }
+        for (uint64_t t = thread->deadline; t <= bound; t += thread->period)
+        {
+            if (++checkpoints > EDFMAXCHECKPOINTS)
+            {
+                *verdict = "too many deadlines to check";
+                return false;
+            }
+
+            uint64_t demand = ceilDiv(t, tick) * switchCycles;
+            for (unsigned other = 0; other < numThreads; other++)
+            {
+                const Thread *job = &threads[other];
+                if (!job->background && t >= job->deadline)
+                {
+                    demand += ((t - job->deadline) / job->period + 1) * cost(job);
+                }
+            }
+
+            // SRP: a job with a later deadline can be in a critical section
+            //   on a resource used by a job with an earlier deadline
+            uint64_t blocking = 0;
+            for (unsigned late = 0; late < numThreads; late++)
+            {
+                if (threads[late].background || threads[late].deadline <= t)
+                {
+                    continue;
+                }
+                for (unsigned early = 0; early < numThreads; early++)
+                {
+                    if (threads[early].background || threads[early].deadline > t)
+                    {
+                        continue;
+                    }
+                    for (unsigned res = 0; res < threads[late].numResources; res++)
+                    {
+                        if (criticalSection(&threads[early], threads[late].resources[res].name) &&
+                            threads[late].resources[res].cycles > blocking)
+                        {
+                            blocking = threads[late].resources[res].cycles;
+                        }
+                    }
+                }
+            }
+
+            if (demand + blocking > t)
+            {
+                static char text[96];
+                snprintf(text, sizeof(text), "demand exceeds time available at %.3f ms", cyclesToMs(t));
+                *verdict = text;
+                return false;
+            }
+        }
+    }
+    *verdict = "demand within time available at every deadline";
+    return true;
+}
+
+static uint64_t ceilDiv(uint64_t a, uint64_t b)
+{
+    return (a + b - 1) / b;
+}
+
+static double cyclesToMs(uint64_t cycles)
+{
+    return (double)cycles * 1000 / clockHz;
+}
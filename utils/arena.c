@@ -0,0 +1,53 @@
+#include <stdint.h>
+#include <driverlib/debug.h>
+
+#include "arena.h"
+
+#define NULL 0
+
+void Arena_Init(Arena *arena, void *buffer, uint32_t size)
+{
+    uintptr_t start = ((uintptr_t)buffer + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+    arena->start = (uint8_t *)start;
+    arena->end = (uint8_t *)buffer + size;
+    if (arena->end < arena->start)
+    {
+        // the buffer is smaller than the alignment padding: nothing to allocate
+        arena->end = arena->start;
+    }
+    arena->top = arena->start;
+    arena->peak = arena->start;
+}
+
+void *Arena_Alloc(Arena *arena, uint32_t size)
+{
+    uint8_t *pt = arena->top;
+    uint32_t alignedSize = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    if (alignedSize > (uint32_t)(arena->end - pt))
+    {
+        return NULL;
+    }
+
+    arena->top = pt + alignedSize;
+    if (arena->top > arena->peak)
+    {
+        arena->peak = arena->top;
+    }
+    return pt;
+}
+
+ArenaMark Arena_Mark(Arena *arena)
+{
+    return arena->top;
+}
+
+void Arena_Reset(Arena *arena, ArenaMark mark)
+{
+    ASSERT((mark >= arena->start) && (mark <= arena->top));
+    arena->top = mark;
+}
+
+uint32_t Arena_PeakGet(Arena *arena)
+{
+    return arena->peak - arena->start;
+}
@@ -0,0 +1,26 @@
+#include <stdint.h>
+
+#include "vertical-debounce.h"
+
+void VerticalDebounce_Init(VerticalDebounce *debounce, uint32_t initialSample)
+{
+    debounce->state = initialSample;
+    debounce->count0 = 0;
+    debounce->count1 = 0;
+}
+
+uint32_t VerticalDebounce_Update(VerticalDebounce *debounce, uint32_t sample)
+{
+    uint32_t delta = sample ^ debounce->state;
+
+    // inputs whose counter was already 3, that is, the 4th differing sample
+    uint32_t toggled = delta & debounce->count0 & debounce->count1;
+
+    // increment the counters of the differing inputs, reset the others;
+    //   the counters of toggled inputs wrap around to 0
+    debounce->count1 = (debounce->count1 ^ debounce->count0) & delta;
+    debounce->count0 = ~debounce->count0 & delta;
+
+    debounce->state ^= toggled;
+    return toggled;
+}